@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include <tss/address.hxx>
+#include <tss/exceptions.hxx>
+
+static void resolve_ip_address_v4(benchmark::State& state)
+{
+  for (auto _: state) {
+    benchmark::DoNotOptimize(tss::resolve_ip_address_v4("192.168.178.1"));
+  }
+}
+
+BENCHMARK(resolve_ip_address_v4);
+
+static void resolve_ip_address_v6(benchmark::State& state)
+{
+  for (auto _: state) {
+    benchmark::DoNotOptimize(tss::resolve_ip_address_v6("2001:db8::8a2e:370:7334"));
+  }
+}
+
+BENCHMARK(resolve_ip_address_v6);
+
+static void resolve_ip_addresses_localhost(benchmark::State& state)
+{
+  try {
+    for (auto _: state) {
+      benchmark::DoNotOptimize(tss::resolve_ip_addresses("localhost"));
+    }
+  }
+  catch (tss::address_info_error const& ex) {
+    state.SkipWithError(ex.what());
+  }
+}
+
+BENCHMARK(resolve_ip_addresses_localhost);
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <tss/selector.hxx>
+#include <tss/socket.hxx>
+
+#if defined(__linux__)
+
+#include <tss/poller.hxx>
+
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+  /**
+   * Descriptors to wait on, of which only the last one is readable.
+   */
+  struct descriptors final {
+    std::vector<tss::udp_socket_4> sockets;
+
+    explicit descriptors(std::size_t const count, tss::port_t const port)
+        :sockets(count)
+    {
+      tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), port};
+      sockets.back().set_reuse_addr();
+      sockets.back().bind(address);
+      sockets.front().send_to(address, std::uint32_t{0U});
+    }
+  };
+}
+
+static void selector_wait(benchmark::State& state)
+{
+  descriptors const waiting{static_cast<std::size_t>(state.range(0)), 12384U};
+  tss::selector selector{};
+  for (auto _: state) {
+    // select overwrites its sets, so they have to be filled again for every call
+    selector.clear();
+    for (auto const& sock: waiting.sockets) {
+      selector.add_read(sock);
+    }
+    benchmark::DoNotOptimize(selector.select());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+// select cannot handle descriptors beyond FD_SETSIZE, which is usually 1024
+BENCHMARK(selector_wait)->RangeMultiplier(4)->Range(1, 512);
+
+#if defined(__linux__)
+
+static void poller_wait(benchmark::State& state)
+{
+  descriptors const waiting{static_cast<std::size_t>(state.range(0)), 12385U};
+  tss::poller poller{};
+  for (auto const& sock: waiting.sockets) {
+    poller.add(sock, tss::poll_event_t::Read);
+  }
+  for (auto _: state) {
+    benchmark::DoNotOptimize(poller.wait());
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+BENCHMARK(poller_wait)->RangeMultiplier(4)->Range(1, 512);
+
+#endif
@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <tss/socket.hxx>
+
+#include "tcp_pair.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+  /**
+   * Send small messages right away instead of waiting for more data.
+   */
+  void disable_nagle(tss::test::tcp_pair& sockets)
+  {
+    sockets.client.set<tss::options::tcp_nodelay>(true);
+    sockets.server.set<tss::options::tcp_nodelay>(true);
+  }
+}
+
+static void tcp_throughput(benchmark::State& state)
+{
+  tss::test::tcp_pair sockets{12380U};
+  ::disable_nagle(sockets);
+  std::thread drain{[&sockets] {
+    std::vector<std::byte> buffer(1U << 20U);
+    while (sockets.server.receive(gsl::span<std::byte>{buffer})>0U) {
+    }
+  }};
+
+  std::vector<std::byte> const message(static_cast<std::size_t>(state.range(0)));
+  for (auto _: state) {
+    sockets.client.send_all(gsl::span<std::byte const>{message});
+  }
+  sockets.client.shutdown(tss::shutdown_t::Write);
+  drain.join();
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())*state.range(0));
+}
+
+BENCHMARK(tcp_throughput)->RangeMultiplier(16)->Range(64, 1 << 20)->UseRealTime();
+
+static void tcp_ping_pong(benchmark::State& state)
+{
+  tss::test::tcp_pair sockets{12381U};
+  ::disable_nagle(sockets);
+  auto const size = static_cast<std::size_t>(state.range(0));
+  std::thread echo{[&sockets, size] {
+    std::vector<std::byte> buffer(size);
+    while (sockets.server.receive_exact(gsl::span<std::byte>{buffer})==size) {
+      sockets.server.send_all(gsl::span<std::byte const>{buffer});
+    }
+  }};
+
+  std::vector<std::byte> buffer(size);
+  for (auto _: state) {
+    sockets.client.send_all(gsl::span<std::byte const>{buffer});
+    sockets.client.receive_exact(gsl::span<std::byte>{buffer});
+  }
+  sockets.client.shutdown(tss::shutdown_t::Write);
+  echo.join();
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+
+BENCHMARK(tcp_ping_pong)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
+
+static void udp_packets(benchmark::State& state)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12382U};
+  tss::udp_socket_4 receiver{};
+  receiver.set_reuse_addr();
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  std::vector<std::byte> buffer(static_cast<std::size_t>(state.range(0)));
+  for (auto _: state) {
+    sender.send_to(address, gsl::span<std::byte const>{buffer});
+    receiver.receive_from(nullptr, gsl::span<std::byte>{buffer});
+  }
+
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())*state.range(0));
+}
+
+BENCHMARK(udp_packets)->Arg(64)->Arg(1200)->Arg(8192);
+
+static void udp_packets_batched(benchmark::State& state)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12383U};
+  tss::udp_socket_4 receiver{};
+  receiver.set_reuse_addr();
+  receiver.bind(address);
+  receiver.set<tss::options::receive_buffer_size>(1U << 20U);
+  tss::udp_socket_4 sender{};
+
+  auto const size = static_cast<std::size_t>(state.range(0));
+  std::vector<std::byte> storage(size*tss::max_batched_datagrams);
+  std::vector<tss::outgoing_datagram<tss::ip_version_t::V4>> outgoing{};
+  std::vector<tss::incoming_datagram<tss::ip_version_t::V4>> incoming{};
+  for (std::size_t i = 0U; i<tss::max_batched_datagrams; ++i) {
+    auto const slot = gsl::span<std::byte>{storage}.subspan(i*size, size);
+    outgoing.push_back({slot, address});
+    incoming.push_back({slot, 0U, {}});
+  }
+
+  std::int64_t packets{0};
+  for (auto _: state) {
+    auto const sent = sender.send_batch(gsl::span<tss::outgoing_datagram<tss::ip_version_t::V4> const>{outgoing});
+    for (std::size_t received = 0U; received<sent;) {
+      received += receiver.receive_batch(
+          gsl::span<tss::incoming_datagram<tss::ip_version_t::V4>>{incoming}.first(sent-received));
+    }
+    packets += static_cast<std::int64_t>(sent);
+  }
+
+  state.SetItemsProcessed(packets);
+  state.SetBytesProcessed(packets*state.range(0));
+}
+
+BENCHMARK(udp_packets_batched)->Arg(64)->Arg(1200);
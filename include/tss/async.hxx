@@ -0,0 +1,238 @@
+#pragma once
+
+#include "concepts.hxx"
+#include "enums.hxx"
+#include "exceptions.hxx"
+#include "native.hxx"
+#include "socket.hxx"
+#include "task.hxx"
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+
+namespace tss {
+  namespace detail {
+    struct reactor_data;
+  }
+
+  /**
+   * Single threaded event loop resuming coroutines once their sockets become ready.
+   *
+   * Operations are attempted right away and only wait for readiness if they would block.
+   * Sockets are switched to non-blocking mode the first time they are used with the reactor.
+   * At most one coroutine may wait for reading and one for writing on the same socket at a time.
+   * Currently only available on Linux, where it is built on the poller.
+   */
+  class reactor final {
+    using traits = native::socket_traits;
+
+  public:
+    explicit reactor(native::socket_api const& = native::socket_api::instance());
+
+    reactor(reactor const&) = delete;
+
+    reactor& operator=(reactor const&) = delete;
+
+    ~reactor() noexcept;
+
+    /**
+     * Start a coroutine. It runs until it first has to wait and is then driven by run.
+     * @param coroutine The coroutine to start. Its exceptions are rethrown by run.
+     */
+    void spawn(task<void> coroutine);
+
+    /**
+     * Drive the spawned coroutines until all of them finished or stop was called.
+     * @throws The first exception that escaped a spawned coroutine.
+     */
+    void run();
+
+    /**
+     * Wait for ready sockets once and resume the coroutines waiting on them.
+     * @param time_out How long to wait. A negative value waits until at least one socket is ready.
+     * @return The number of resumed coroutines.
+     */
+    std::size_t run_once(std::chrono::milliseconds time_out = std::chrono::milliseconds{-1});
+
+    /**
+     * Make run return after the current iteration.
+     */
+    void stop() noexcept;
+
+    /**
+     * Switch a socket to non-blocking mode, unless the reactor already did so.
+     * @throws socket_error If the native fcntl call fails.
+     */
+    template<concepts::Socket TSocket>
+    void prepare(TSocket const& sock)
+    {
+      prepare_(sock.native_handle());
+    }
+
+    /**
+     * Forget a socket before closing it. Must not be called while a coroutine waits on the socket.
+     */
+    template<concepts::Socket TSocket>
+    void release(TSocket const& sock)
+    {
+      release_(sock.native_handle());
+    }
+
+    /**
+     * Suspend the awaiting coroutine until the socket is readable.
+     */
+    template<concepts::Socket TSocket>
+    [[nodiscard]] auto readable(TSocket const& sock) noexcept
+    {
+      return readiness{*this, sock.native_handle(), poll_event_t::Read};
+    }
+
+    /**
+     * Suspend the awaiting coroutine until the socket is writable.
+     */
+    template<concepts::Socket TSocket>
+    [[nodiscard]] auto writable(TSocket const& sock) noexcept
+    {
+      return readiness{*this, sock.native_handle(), poll_event_t::Write};
+    }
+
+  private:
+    struct readiness final {
+      reactor& owner;
+      traits::socket_t socket;
+      poll_event_t event;
+
+      [[nodiscard]] bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      void await_suspend(std::coroutine_handle<> const coroutine) const
+      {
+        owner.wait_(socket, event, coroutine);
+      }
+
+      void await_resume() const noexcept
+      {
+      }
+    };
+
+    void wait_(traits::socket_t sock, poll_event_t event, std::coroutine_handle<> coroutine);
+
+    void prepare_(traits::socket_t sock);
+
+    void release_(traits::socket_t sock);
+
+    std::unique_ptr<detail::reactor_data> data_;
+  };
+
+  /**
+   * Accept a connection without blocking the reactor.
+   * @param address The address of the connecting client. Can be nullptr if irrelevant.
+   * @return The socket for the new connection.
+   * @throws socket_error If the native accept call fails.
+   */
+  template<ip_version_t TIP>
+  task<socket<TIP, protocol_t::TCP>>
+  async_accept(reactor& loop, socket<TIP, protocol_t::TCP>& sock, address_t<TIP>* address = nullptr)
+  {
+    loop.prepare(sock);
+    for (;;) {
+      if (auto result = sock.accept(std::nothrow, address); result || !result.error().would_block()) {
+        co_return std::move(result).value();
+      }
+      co_await loop.readable(sock);
+    }
+  }
+
+  /**
+   * Establish a connection to a server without blocking the reactor.
+   * @throws socket_error If the connection could not be established.
+   */
+  template<ip_version_t TIP>
+  task<void> async_connect(reactor& loop, socket<TIP, protocol_t::TCP>& sock, address_t<TIP> const& address);
+
+  /**
+   * Send data to the connected peer without blocking the reactor.
+   * @return The number of bytes actually transmitted.
+   * @throws socket_error If the native send call fails.
+   */
+  template<ip_version_t TIP, concepts::Data TData>
+  requires (!concepts::View<TData>)
+  task<std::size_t> async_send(reactor& loop, socket<TIP, protocol_t::TCP>& sock, TData const& data)
+  {
+    loop.prepare(sock);
+    for (;;) {
+      if (auto result = sock.send(std::nothrow, data); result || !result.error().would_block()) {
+        co_return std::move(result).value();
+      }
+      co_await loop.writable(sock);
+    }
+  }
+
+  /**
+   * Receive data from the connected peer without blocking the reactor.
+   * @return The number of bytes actually received.
+   * @throws socket_error If the native recv call fails.
+   */
+  template<ip_version_t TIP, concepts::Data TData>
+  requires (!concepts::View<TData>)
+  task<std::size_t> async_receive(reactor& loop, socket<TIP, protocol_t::TCP>& sock, TData& buffer)
+  {
+    loop.prepare(sock);
+    for (;;) {
+      if (auto result = sock.receive(std::nothrow, buffer); result || !result.error().would_block()) {
+        co_return std::move(result).value();
+      }
+      co_await loop.readable(sock);
+    }
+  }
+
+  /**
+   * Send data to the given address without blocking the reactor.
+   * @return The number of bytes actually transmitted.
+   * @throws socket_error If the native sendto call fails.
+   */
+  template<ip_version_t TIP, concepts::Data TData>
+  requires (!concepts::View<TData>)
+  task<std::size_t>
+  async_send_to(reactor& loop, socket<TIP, protocol_t::UDP>& sock, address_t<TIP> const address, TData const& data)
+  {
+    loop.prepare(sock);
+    for (;;) {
+      if (auto result = sock.send_to(std::nothrow, address, data); result || !result.error().would_block()) {
+        co_return std::move(result).value();
+      }
+      co_await loop.writable(sock);
+    }
+  }
+
+  /**
+   * Receive data from somewhere without blocking the reactor.
+   * @param address The sender address. Can be nullptr if irrelevant.
+   * @return The number of bytes actually received.
+   * @throws socket_error If the native recvfrom call fails.
+   */
+  template<ip_version_t TIP, concepts::Data TData>
+  requires (!concepts::View<TData>)
+  task<std::size_t>
+  async_receive_from(reactor& loop, socket<TIP, protocol_t::UDP>& sock, address_t<TIP>* address, TData& buffer)
+  {
+    loop.prepare(sock);
+    for (;;) {
+      if (auto result = sock.receive_from(std::nothrow, address, buffer); result || !result.error().would_block()) {
+        co_return std::move(result).value();
+      }
+      co_await loop.readable(sock);
+    }
+  }
+
+  extern template
+  task<void> async_connect(reactor&, socket<ip_version_t::V4, protocol_t::TCP>&, address_v4_t const&);
+
+  extern template
+  task<void> async_connect(reactor&, socket<ip_version_t::V6, protocol_t::TCP>&, address_v6_t const&);
+}
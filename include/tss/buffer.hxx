@@ -0,0 +1,190 @@
+#pragma once
+
+#include "concepts.hxx"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+#include <gsl/assert>
+#include <gsl/span>
+
+namespace tss {
+  /**
+   * A view on bytes to be sent.
+   */
+  using const_buffer = gsl::span<std::byte const>;
+
+  /**
+   * A view on bytes receiving incoming data.
+   */
+  using mutable_buffer = gsl::span<std::byte>;
+
+  /**
+   * The maximum number of buffers transferred by a single vectored send or receive.
+   */
+  std::size_t constexpr max_vectored_buffers{64U};
+
+  /**
+   * Describes how far a vectored send or receive got.
+   */
+  struct vectored_progress final {
+    /**
+     * The total number of bytes transferred.
+     */
+    std::size_t bytes;
+
+    /**
+     * The number of buffers that were transferred completely.
+     */
+    std::size_t buffers;
+
+    /**
+     * The number of bytes transferred from the first buffer that was not transferred completely.
+     */
+    std::size_t offset;
+  };
+
+  template<concepts::Data TData>
+  requires (!concepts::View<TData>)
+  [[nodiscard]] const_buffer make_buffer(TData const& data) noexcept
+  {
+    return const_buffer{reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData)};
+  }
+
+  template<concepts::Data TData>
+  requires (!std::is_const_v<TData> && !concepts::View<TData>)
+  [[nodiscard]] mutable_buffer make_buffer(TData& data) noexcept
+  {
+    return mutable_buffer{reinterpret_cast<std::byte*>(std::addressof(data)), sizeof(TData)};
+  }
+
+  template<concepts::Data TData, std::size_t TExtent>
+  [[nodiscard]] auto make_buffer(gsl::span<TData, TExtent> const data) noexcept
+  {
+    if constexpr (std::is_const_v<TData>) {
+      return const_buffer{reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()};
+    }
+    else {
+      return mutable_buffer{reinterpret_cast<std::byte*>(data.data()), data.size_bytes()};
+    }
+  }
+
+  template<concepts::Data TData, std::size_t TExtent>
+  [[nodiscard]] auto make_buffer(std::span<TData, TExtent> const data) noexcept
+  {
+    if constexpr (std::is_const_v<TData>) {
+      return const_buffer{reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()};
+    }
+    else {
+      return mutable_buffer{reinterpret_cast<std::byte*>(data.data()), data.size_bytes()};
+    }
+  }
+
+  /**
+   * Drop everything that was already transferred, so a short vectored send or receive can be resumed.
+   * The first remaining buffer is adjusted in place.
+   * @param all The buffers passed to the vectored call.
+   * @param progress The progress reported by the vectored call.
+   * @return The buffers still to be transferred.
+   */
+  template<typename TBuffer, std::size_t TExtent>
+  requires std::is_same_v<TBuffer, const_buffer> || std::is_same_v<TBuffer, mutable_buffer>
+  [[nodiscard]] gsl::span<TBuffer>
+  remaining_buffers(gsl::span<TBuffer, TExtent> const all, vectored_progress const& progress)
+  {
+    auto buffers = gsl::span<TBuffer>{all}.subspan(progress.buffers);
+    if (!buffers.empty() && progress.offset>0U) {
+      buffers[0U] = buffers[0U].subspan(progress.offset);
+    }
+    return buffers;
+  }
+
+  /**
+   * Splits a buffer into consecutive segments of a fixed size without copying. Only the last segment may be shorter.
+   * @tparam TBuffer Either const_buffer or mutable_buffer.
+   */
+  template<typename TBuffer>
+  class segment_view final {
+  public:
+    class iterator final {
+    public:
+      using value_type = TBuffer;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() noexcept = default;
+
+      iterator(TBuffer const rest, std::size_t const segment_size) noexcept
+          :rest_{rest}, segment_size_{segment_size}
+      {
+      }
+
+      TBuffer operator*() const noexcept
+      {
+        return rest_.first(std::min(segment_size_, rest_.size()));
+      }
+
+      iterator& operator++() noexcept
+      {
+        rest_ = rest_.subspan(std::min(segment_size_, rest_.size()));
+        return *this;
+      }
+
+      iterator operator++(int) noexcept
+      {
+        auto const previous{*this};
+        ++*this;
+        return previous;
+      }
+
+      bool operator==(iterator const& other) const noexcept
+      {
+        return rest_.size()==other.rest_.size();
+      }
+
+    private:
+      TBuffer rest_{};
+      std::size_t segment_size_{0U};
+    };
+
+    segment_view(TBuffer const buffer, std::size_t const segment_size)
+        :buffer_{buffer}, segment_size_{segment_size}
+    {
+      Expects(segment_size>0U);
+    }
+
+    [[nodiscard]] iterator begin() const noexcept
+    {
+      return {buffer_, segment_size_};
+    }
+
+    [[nodiscard]] iterator end() const noexcept
+    {
+      return {buffer_.last(0U), segment_size_};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return (buffer_.size()+segment_size_-1U)/segment_size_;
+    }
+
+  private:
+    TBuffer buffer_;
+    std::size_t segment_size_;
+  };
+
+  /**
+   * Split a buffer into segments, e.g. the individual datagrams of a coalesced receive.
+   * @param buffer The bytes to split.
+   * @param segment_size The size of every segment but the last. Must not be zero.
+   */
+  template<typename TBuffer>
+  requires std::is_same_v<TBuffer, const_buffer> || std::is_same_v<TBuffer, mutable_buffer>
+  [[nodiscard]] segment_view<TBuffer> segments(TBuffer const buffer, std::size_t const segment_size)
+  {
+    return segment_view<TBuffer>{buffer, segment_size};
+  }
+}
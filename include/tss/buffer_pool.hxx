@@ -0,0 +1,212 @@
+#pragma once
+
+#include "buffer.hxx"
+#include "result.hxx"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace tss {
+  class buffer_pool;
+
+  namespace detail {
+    struct thread_buffer_cache;
+  }
+
+  /**
+   * A buffer borrowed from a buffer_pool, which is returned to the pool on destruction.
+   */
+  class pooled_buffer final {
+  public:
+    /**
+     * Creates an empty buffer without memory.
+     */
+    pooled_buffer() noexcept = default;
+
+    pooled_buffer(pooled_buffer&& other) noexcept;
+
+    pooled_buffer& operator=(pooled_buffer&& other) noexcept;
+
+    ~pooled_buffer() noexcept;
+
+    /**
+     * @return Whether the buffer holds memory of a pool.
+     */
+    [[nodiscard]] explicit operator bool() const noexcept
+    {
+      return pool_!=nullptr;
+    }
+
+    /**
+     * @return The bytes in use, e.g. the bytes received into the buffer.
+     */
+    [[nodiscard]] mutable_buffer data() const noexcept
+    {
+      return mutable_buffer{data_, size_};
+    }
+
+    /**
+     * @return The number of bytes in use.
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return size_;
+    }
+
+    /**
+     * @return The number of bytes the buffer can hold, which is the buffer size of its pool.
+     */
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+      return capacity_;
+    }
+
+    /**
+     * Set the number of bytes in use.
+     * @param size The number of bytes in use, at most the capacity.
+     */
+    void resize(std::size_t size) noexcept;
+
+    /**
+     * Return the memory to the pool early, leaving the buffer empty.
+     */
+    void reset() noexcept;
+
+  private:
+    friend class buffer_pool;
+
+    pooled_buffer(buffer_pool& pool, std::uint32_t index, std::byte* data, std::size_t capacity) noexcept;
+
+    buffer_pool* pool_{nullptr};
+    std::uint32_t index_{0U};
+    std::byte* data_{nullptr};
+    std::size_t size_{0U};
+    std::size_t capacity_{0U};
+  };
+
+  /**
+   * The occupancy of a buffer_pool, for monitoring.
+   */
+  struct buffer_pool_stats final {
+    /**
+     * The size of each buffer in bytes.
+     */
+    std::size_t buffer_size{0U};
+
+    /**
+     * The number of buffers backed by memory, which grows slab by slab.
+     */
+    std::size_t allocated{0U};
+
+    /**
+     * The maximum number of buffers.
+     */
+    std::size_t max_buffers{0U};
+
+    /**
+     * The number of buffers currently borrowed.
+     */
+    std::size_t in_use{0U};
+
+    /**
+     * The highest number of buffers borrowed at the same time.
+     */
+    std::size_t peak_in_use{0U};
+
+    /**
+     * The number of times a buffer was requested while all buffers were borrowed.
+     */
+    std::uint64_t exhausted{0U};
+  };
+
+  /**
+   * Hands out fixed-size buffers shared by many connections, so memory is only held while data is in flight instead of
+   * a worst-case buffer per connection.
+   *
+   * Buffers are carved from slabs allocated on demand up to a maximum and never freed before the pool. Free buffers are
+   * kept in a lock-free stack and every thread keeps a few of them in a cache of its own, which it refills from and
+   * returns to the stack in batches, so borrowing a buffer usually touches no shared state but the occupancy counter.
+   * Buffers cached by one thread are not available to others, so allow for up to cache_size idle buffers per thread
+   * when choosing the maximum. The pool must outlive all its buffers.
+   */
+  class buffer_pool final {
+  public:
+    /**
+     * @param buffer_size The size of each buffer in bytes.
+     * @param max_buffers The maximum number of buffers.
+     * @param slab_buffers The number of buffers allocated at once when the pool grows.
+     * @param cache_size The number of free buffers each thread keeps to itself.
+     */
+    explicit buffer_pool(
+        std::size_t buffer_size,
+        std::size_t max_buffers,
+        std::size_t slab_buffers = 64U,
+        std::size_t cache_size = 32U
+    );
+
+    buffer_pool(buffer_pool const&) = delete;
+
+    buffer_pool& operator=(buffer_pool const&) = delete;
+
+    ~buffer_pool() noexcept;
+
+    /**
+     * Borrow a buffer, whose size is set to the full capacity.
+     * @return The buffer.
+     * @throws socket_error If all buffers are borrowed or a slab could not be allocated.
+     */
+    pooled_buffer acquire();
+
+    /**
+     * Borrow a buffer without throwing.
+     * @return The buffer, or error_code::no_buffer_space if all buffers are borrowed or a slab could not be allocated.
+     */
+    result<pooled_buffer> acquire(std::nothrow_t) noexcept;
+
+    /**
+     * @return The size of each buffer in bytes.
+     */
+    [[nodiscard]] std::size_t buffer_size() const noexcept
+    {
+      return buffer_size_;
+    }
+
+    /**
+     * @return The current occupancy. Counters are read independently, so they may be slightly out of sync.
+     */
+    [[nodiscard]] buffer_pool_stats stats() const noexcept;
+
+  private:
+    friend class pooled_buffer;
+    friend struct detail::thread_buffer_cache;
+
+    void release_(std::uint32_t index) noexcept;
+
+    std::byte* data_(std::uint32_t index) const noexcept;
+
+    bool grow_() noexcept;
+
+    std::size_t pop_(std::uint32_t* indices, std::size_t count) noexcept;
+
+    void push_(std::uint32_t const* indices, std::size_t count) noexcept;
+
+    std::uint64_t id_;
+    std::size_t buffer_size_;
+    std::size_t max_buffers_;
+    std::size_t slab_buffers_;
+    std::size_t cache_size_;
+    std::vector<std::unique_ptr<std::byte[]>> slabs_;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> next_;
+    std::mutex grow_mutex_{};
+    std::atomic<std::size_t> allocated_{0U};
+    alignas(64) std::atomic<std::uint64_t> head_;
+    alignas(64) std::atomic<std::size_t> in_use_{0U};
+    std::atomic<std::size_t> peak_in_use_{0U};
+    std::atomic<std::uint64_t> exhausted_{0U};
+  };
+}
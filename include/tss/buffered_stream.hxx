@@ -0,0 +1,149 @@
+#pragma once
+
+#include "buffer.hxx"
+#include "concepts.hxx"
+#include "enums.hxx"
+#include "result.hxx"
+#include "socket.hxx"
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <vector>
+
+#include <gsl/span>
+
+namespace tss {
+  /**
+   * Buffers sends and receives of a TCP socket, so many small values cost one native call per buffer instead of one
+   * per value.
+   *
+   * Sends are collected in the write buffer until it is full or flush is called. Sends larger than the write buffer are
+   * passed on together with the buffered data in a single vectored send. Receives are served from a read-ahead buffer,
+   * which is refilled by a single receive of up to its capacity. Meant for blocking sockets.
+   * @tparam TIP The IP version of the socket.
+   */
+  template<ip_version_t TIP>
+  class buffered_stream final {
+  public:
+    using socket_t = socket<TIP, protocol_t::TCP>;
+
+    /**
+     * @param sock The socket to send to and receive from, which must outlive the stream.
+     * @param write_capacity The size of the write buffer in bytes.
+     * @param read_capacity The size of the read-ahead buffer in bytes.
+     * @param flush When buffered sends are flushed besides when the write buffer is full. The default flushes before
+     * waiting for data, so a request is on its way before its response is awaited.
+     */
+    explicit buffered_stream(
+        socket_t& sock,
+        std::size_t write_capacity = 16U*1024U,
+        std::size_t read_capacity = 16U*1024U,
+        flush_t flush = flush_t::BeforeReceive
+    );
+
+    buffered_stream(buffered_stream const&) = delete;
+
+    buffered_stream& operator=(buffered_stream const&) = delete;
+
+    /**
+     * Flushes buffered sends, ignoring errors. Call flush beforehand to be notified about them.
+     */
+    ~buffered_stream() noexcept;
+
+    /**
+     * Buffer data for sending.
+     * @tparam TData The type of data to send.
+     * @param data The data to send.
+     * @throws socket_error If flushing a full write buffer or sending large data fails. Buffered data that was sent
+     * before the failure is dropped from the write buffer, the rest stays buffered.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    void send(TData const& data)
+    {
+      write_(make_buffer(data));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    void send(gsl::span<TData, TExtent> const data)
+    {
+      write_(make_buffer(gsl::span<TData const, TExtent>{data}));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    void send(std::span<TData, TExtent> const data)
+    {
+      write_(make_buffer(std::span<TData const, TExtent>{data}));
+    }
+
+    /**
+     * Send all buffered data.
+     * @throws socket_error If the native send call fails. Data that could not be sent stays buffered.
+     */
+    void flush();
+
+    result<void> flush(std::nothrow_t) noexcept;
+
+    /**
+     * Receive exactly the size of the data, unless the peer closes the connection before.
+     * @tparam TData The type of data to receive.
+     * @param buffer The buffer receiving the data.
+     * @return The number of bytes received, which is only less than the size of the data at the end of the stream.
+     * @throws socket_error If the native receive call or flushing before it fails.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    std::size_t receive(TData& buffer)
+    {
+      return read_(make_buffer(buffer));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t receive(gsl::span<TData, TExtent> const buffer)
+    {
+      return read_(make_buffer(buffer));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t receive(std::span<TData, TExtent> const buffer)
+    {
+      return read_(make_buffer(buffer));
+    }
+
+    /**
+     * @return The number of bytes waiting in the write buffer.
+     */
+    [[nodiscard]] std::size_t pending() const noexcept
+    {
+      return write_buffer_.size();
+    }
+
+    /**
+     * @return The number of bytes in the read-ahead buffer, which can be received without a native call.
+     */
+    [[nodiscard]] std::size_t available() const noexcept
+    {
+      return read_end_-read_begin_;
+    }
+
+  private:
+    void write_(const_buffer data);
+
+    std::size_t read_(mutable_buffer data);
+
+    socket_t* sock_;
+    std::size_t write_capacity_;
+    flush_t flush_;
+    std::vector<std::byte> write_buffer_;
+    std::vector<std::byte> read_buffer_;
+    std::size_t read_begin_{0U};
+    std::size_t read_end_{0U};
+  };
+
+  extern template
+  class buffered_stream<ip_version_t::V4>;
+
+  extern template
+  class buffered_stream<ip_version_t::V6>;
+}
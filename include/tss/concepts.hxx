@@ -1,14 +1,41 @@
 #pragma once
 
 #include <concepts>
+#include <ranges>
+#include <span>
+#include <string_view>
 #include <type_traits>
 
+#include <gsl/span>
+
 #include "native.hxx"
 
 namespace tss::concepts {
+  namespace detail {
+    template<typename T>
+    struct is_span : std::false_type {
+    };
+
+    template<typename T, std::size_t TExtent>
+    struct is_span<std::span<T, TExtent>> : std::true_type {
+    };
+
+    template<typename T, std::size_t TExtent>
+    struct is_span<gsl::span<T, TExtent>> : std::true_type {
+    };
+  }
+
   template<typename T>
   concept Data = std::is_standard_layout_v<T>;
 
+  /**
+   * A type referring to data elsewhere, like a span or string view. Sending one as an object would transmit its
+   * pointer and size instead of the data, so the overloads taking single objects reject it.
+   */
+  template<typename T>
+  concept View = detail::is_span<std::remove_cv_t<T>>::value || std::ranges::view<std::remove_cv_t<T>> ||
+      std::ranges::borrowed_range<std::remove_cv_t<T>>;
+
   template<typename T>
   concept Socket = requires(T const* t) {
     { t->native_handle() } -> std::same_as<native::socket_traits::socket_t>;
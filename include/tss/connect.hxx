@@ -0,0 +1,51 @@
+#pragma once
+
+#include "address.hxx"
+#include "native.hxx"
+#include "socket.hxx"
+
+#include <chrono>
+#include <string_view>
+#include <variant>
+
+#include <gsl/span>
+
+namespace tss {
+  /**
+   * A TCP socket of either IP version, e.g. the winner of connect_any.
+   */
+  using any_tcp_socket = std::variant<tcp_socket_4, tcp_socket_6>;
+
+  /**
+   * Connect to the first of the given addresses that answers (Happy Eyeballs, RFC 8305).
+   *
+   * Attempts alternate between IPv6 and IPv4, starting with IPv6. A new attempt starts whenever the previous one failed
+   * or did not succeed within the attempt delay, while earlier attempts keep running. The first connection established
+   * wins and all others are closed, so a broken path of one IP version only costs the attempt delay.
+   * @param addresses The addresses of the server.
+   * @param port The port of the server.
+   * @param attempt_delay How long to wait for an attempt before starting the next one.
+   * @param time_out How long to wait in total.
+   * @return The connected socket in blocking mode.
+   * @throws socket_error If no attempt succeeded, with the error of the last failed attempt or a time out.
+   */
+  any_tcp_socket connect_any(
+      gsl::span<std::variant<ip_address_v4_t, ip_address_v6_t> const> addresses,
+      port_t port,
+      std::chrono::milliseconds attempt_delay = std::chrono::milliseconds{250},
+      std::chrono::milliseconds time_out = std::chrono::seconds{30}
+  );
+
+  /**
+   * Resolve a host and connect to whichever of its addresses answers first, see the overload taking addresses.
+   * @throws address_info_error If the host cannot be resolved.
+   * @throws socket_error If no attempt succeeded.
+   */
+  any_tcp_socket connect_any(
+      std::string_view host,
+      port_t port,
+      std::chrono::milliseconds attempt_delay = std::chrono::milliseconds{250},
+      std::chrono::milliseconds time_out = std::chrono::seconds{30},
+      native::socket_api const& = native::socket_api::instance()
+  );
+}
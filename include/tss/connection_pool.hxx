@@ -0,0 +1,132 @@
+#pragma once
+
+#include "address.hxx"
+#include "enums.hxx"
+#include "socket.hxx"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+namespace tss {
+  namespace detail {
+    template<ip_version_t TIP>
+    struct connection_pool_data;
+  }
+
+  /**
+   * Keeps TCP connections to servers open, so they can be reused instead of connecting for every request.
+   *
+   * Connections are grouped by the address of their server, with a limit on the number of connections per server.
+   * Servers are spread across independently locked shards, so threads using different servers rarely contend.
+   * Idle connections are checked for liveness when they are handed out again and can be evicted after a while.
+   * @tparam TIP The IP version of the connections.
+   */
+  template<ip_version_t TIP>
+  class connection_pool final {
+  public:
+    using socket_t = socket<TIP, protocol_t::TCP>;
+
+    /**
+     * A connection handed out by the pool. Returns the connection to the pool when destroyed.
+     */
+    class lease final {
+    public:
+      lease(lease&& src) noexcept;
+
+      lease(lease const&) = delete;
+
+      lease& operator=(lease&&) = delete;
+
+      lease& operator=(lease const&) = delete;
+
+      ~lease() noexcept;
+
+      socket_t& operator*() noexcept
+      {
+        return *sock_;
+      }
+
+      socket_t* operator->() noexcept
+      {
+        return &*sock_;
+      }
+
+      /**
+       * Close the connection instead of returning it, e.g. because the protocol state is unknown after an error.
+       */
+      void discard() noexcept;
+
+      /**
+       * Take the connection out of the pool for good. It no longer counts towards the limit of its server.
+       */
+      socket_t release() &&;
+
+    private:
+      friend class connection_pool;
+
+      lease(connection_pool& pool, address_t<TIP> const& address, socket_t&& sock) noexcept;
+
+      connection_pool* pool_;
+      address_t<TIP> address_;
+      std::optional<socket_t> sock_;
+    };
+
+    /**
+     * @param max_per_server The maximum number of connections to a single server, whether idle or in use.
+     * @param idle_time_out How long a connection may stay idle before evict_idle closes it.
+     * @param shards The number of independently locked groups of servers.
+     */
+    explicit connection_pool(
+        std::size_t max_per_server = 8U,
+        std::chrono::milliseconds idle_time_out = std::chrono::seconds{30},
+        std::size_t shards = 16U
+    );
+
+    connection_pool(connection_pool const&) = delete;
+
+    connection_pool& operator=(connection_pool const&) = delete;
+
+    /**
+     * Close all idle connections. All leases must have been returned before.
+     */
+    ~connection_pool() noexcept;
+
+    /**
+     * Hand out a live idle connection to the server or connect a new one.
+     * @param address The address of the server.
+     * @param wait How long to wait for another thread to return a connection if the limit was reached.
+     * @return The lease of the connection.
+     * @throws socket_error If connecting fails or no connection became available in time.
+     */
+    lease acquire(address_t<TIP> const& address, std::chrono::milliseconds wait = std::chrono::milliseconds{0});
+
+    /**
+     * Close all connections that were idle for longer than the idle time out.
+     * @return The number of closed connections.
+     */
+    std::size_t evict_idle();
+
+    /**
+     * @return The number of idle connections.
+     */
+    [[nodiscard]] std::size_t idle() const;
+
+    /**
+     * @return The number of connections, whether idle or in use.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    void give_back_(address_t<TIP> const& address, std::optional<socket_t> sock) noexcept;
+
+    std::unique_ptr<detail::connection_pool_data<TIP>> data_;
+  };
+
+  extern template
+  class connection_pool<ip_version_t::V4>;
+
+  extern template
+  class connection_pool<ip_version_t::V6>;
+}
@@ -23,4 +23,85 @@ namespace tss {
     Write = 2U,
     ReadWrite = 3U,
   };
+
+  enum class poll_event_t : std::uint8_t {
+    None = 0U,
+    Read = 1U,
+    Write = 2U,
+    Error = 4U,
+    HangUp = 8U,
+  };
+
+  [[nodiscard]] constexpr poll_event_t operator|(poll_event_t const lhs, poll_event_t const rhs) noexcept
+  {
+    return static_cast<poll_event_t>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+  }
+
+  [[nodiscard]] constexpr poll_event_t operator&(poll_event_t const lhs, poll_event_t const rhs) noexcept
+  {
+    return static_cast<poll_event_t>(static_cast<std::uint8_t>(lhs) & static_cast<std::uint8_t>(rhs));
+  }
+
+  enum class timestamping_t : std::uint8_t {
+    None = 0U,
+    RxSoftware = 1U,
+    RxHardware = 2U,
+    TxScheduled = 4U,
+    TxSoftware = 8U,
+    TxHardware = 16U,
+    TxAcknowledged = 32U,
+  };
+
+  [[nodiscard]] constexpr timestamping_t operator|(timestamping_t const lhs, timestamping_t const rhs) noexcept
+  {
+    return static_cast<timestamping_t>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+  }
+
+  [[nodiscard]] constexpr timestamping_t operator&(timestamping_t const lhs, timestamping_t const rhs) noexcept
+  {
+    return static_cast<timestamping_t>(static_cast<std::uint8_t>(lhs) & static_cast<std::uint8_t>(rhs));
+  }
+
+  enum class tx_stage_t : std::uint8_t {
+    Scheduled,
+    Sent,
+    Acknowledged,
+  };
+
+  enum class io_operation_t : std::uint8_t {
+    Send,
+    Receive,
+    SendTo,
+    ReceiveFrom,
+    Accept,
+  };
+
+  enum class flush_t : std::uint8_t {
+    Manual,
+    BeforeReceive,
+  };
+
+  enum class trigger_t : std::uint8_t {
+    Level,
+    Edge,
+    OneShot,
+  };
+
+  enum class option_t : std::uint8_t {
+    ReuseAddr,
+    ReusePort,
+    SendBufferSize,
+    ReceiveBufferSize,
+    Priority,
+    KeepAlive,
+    TcpNoDelay,
+    TcpCork,
+    TcpQuickAck,
+    TcpFastOpen,
+    TcpNotSentLowAt,
+    UdpSegment,
+    UdpGro,
+    IpTos,
+    Ipv6V6Only,
+  };
 }
@@ -4,6 +4,78 @@
 #include <string>
 
 namespace tss {
+  /**
+   * An error code reported by a native socket call.
+   * Unlike socket_error it is cheap to create, as the description is only looked up on demand.
+   */
+  class error_code final {
+  public:
+    constexpr explicit error_code(int const value) noexcept
+        :value_{value}
+    {
+    }
+
+    /**
+     * @return The error code of the last failed native socket call on the current thread.
+     */
+    [[nodiscard]] static error_code last() noexcept;
+
+    /**
+     * @return The error code reported when a native call was interrupted by a signal.
+     */
+    [[nodiscard]] static error_code interrupted() noexcept;
+
+    /**
+     * @return The error code reported when an operation is not supported on this platform.
+     */
+    [[nodiscard]] static error_code not_supported() noexcept;
+
+    /**
+     * @return The error code reported when an operation did not finish in time.
+     */
+    [[nodiscard]] static error_code timed_out() noexcept;
+
+    /**
+     * @return The error code reported when memory for a buffer could not be allocated.
+     */
+    [[nodiscard]] static error_code no_buffer_space() noexcept;
+
+    /**
+     * @return The error code reported when an argument is out of range for a native call.
+     */
+    [[nodiscard]] static error_code invalid_argument() noexcept;
+
+    [[nodiscard]] constexpr int value() const noexcept
+    {
+      return value_;
+    }
+
+    /**
+     * @return true, if the operation failed because it would have blocked a non-blocking socket.
+     */
+    [[nodiscard]] bool would_block() const noexcept;
+
+    /**
+     * @return true, if a non-blocking connect was started, but did not complete yet.
+     */
+    [[nodiscard]] bool in_progress() const noexcept;
+
+    /**
+     * @return true, if a pending connection failed before it was accepted, which does not affect the listener.
+     */
+    [[nodiscard]] bool connection_aborted() const noexcept;
+
+    /**
+     * @return The description of the error.
+     */
+    [[nodiscard]] std::string message() const;
+
+    [[nodiscard]] friend constexpr bool operator==(error_code, error_code) noexcept = default;
+
+  private:
+    int value_;
+  };
+
   class exception : public std::runtime_error {
   public:
     using std::runtime_error::runtime_error;
@@ -26,6 +98,14 @@ namespace tss {
     int error_code_;
   };
 
+  /**
+   * Thrown when a peer violates the framing protocol, e.g. by announcing a frame larger than allowed.
+   */
+  class frame_error : public exception {
+  public:
+    using exception::exception;
+  };
+
   class address_info_error : public exception {
   public:
     explicit address_info_error(int error_code);
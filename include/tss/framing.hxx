@@ -0,0 +1,175 @@
+#pragma once
+
+#include "buffer.hxx"
+#include "enums.hxx"
+#include "result.hxx"
+#include "socket.hxx"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <vector>
+
+#include <gsl/span>
+
+namespace tss {
+  /**
+   * How frames are delimited: every payload is preceded by its length as an unsigned integer.
+   */
+  struct frame_format final {
+    /**
+     * The width of the length in bytes, which must be 1, 2, 4 or 8.
+     */
+    std::size_t header_width{4U};
+
+    /**
+     * The byte order of the length. Network protocols usually use big endian.
+     */
+    std::endian byte_order{std::endian::big};
+
+    /**
+     * The largest payload accepted from the peer, which bounds the memory a single frame can claim.
+     */
+    std::size_t max_frame_size{16U*1024U*1024U};
+  };
+
+  /**
+   * Write the header announcing a payload.
+   * @param format The format of the header.
+   * @param length The length of the payload.
+   * @param header The buffer receiving the header, at least header_width bytes long.
+   * @throws frame_error If the length does not fit into the header.
+   */
+  void encode_frame_header(frame_format const& format, std::size_t length, mutable_buffer header);
+
+  /**
+   * Read the length of the payload from a header.
+   * @param format The format of the header.
+   * @param header The header, at least header_width bytes long.
+   * @return The length of the payload.
+   */
+  [[nodiscard]] std::size_t decode_frame_header(frame_format const& format, const_buffer header) noexcept;
+
+  /**
+   * Splits the byte stream received on a TCP socket into frames.
+   *
+   * Frames are parsed in place from a reusable receive buffer and handed out as spans into it, so receiving a frame
+   * costs no allocation. Bytes of a frame split across receives stay where they are until the free space behind them
+   * runs out, only then they are moved to the front. The buffer grows for frames that do not fit at all.
+   * @tparam TIP The IP version of the socket.
+   */
+  template<ip_version_t TIP>
+  class frame_reader final {
+  public:
+    using socket_t = socket<TIP, protocol_t::TCP>;
+
+    /**
+     * @param sock The socket to receive from, which must outlive the reader.
+     * @param format The format of the frames.
+     * @param buffer_size The initial size of the receive buffer.
+     */
+    explicit frame_reader(socket_t& sock, frame_format const& format = {}, std::size_t buffer_size = 64U*1024U);
+
+    /**
+     * Wait for the next frame, receiving as often as necessary.
+     * @return The payload of the frame, valid until the next call to receive or fill. Nothing at the end of the stream.
+     * @throws socket_error If the native recv call fails.
+     * @throws frame_error If the peer announced a frame that is too large or ended the stream within a frame.
+     */
+    std::optional<const_buffer> receive();
+
+    /**
+     * Hand out the next frame that was already received completely, without a native call.
+     * Spans handed out before stay valid, so several frames can be processed after a single fill.
+     * @return The payload of the frame, valid until the next call to receive or fill. Nothing if it is incomplete.
+     * @throws frame_error If the peer announced a frame that is too large.
+     */
+    std::optional<const_buffer> next();
+
+    /**
+     * Receive once into the buffer, e.g. after the poller reported the socket readable.
+     * @return The number of bytes received, zero at the end of the stream, or the error code of the native recv call.
+     * Fails with error_code::no_buffer_space if the buffer could not grow for a large frame.
+     */
+    result<std::size_t> fill(std::nothrow_t) noexcept;
+
+    /**
+     * @return The number of received bytes that were not handed out as frames yet.
+     */
+    [[nodiscard]] std::size_t buffered() const noexcept
+    {
+      return end_-begin_;
+    }
+
+  private:
+    /**
+     * @return The size of the frame at the front including its header, if its header was received.
+     */
+    std::optional<std::size_t> frame_size_() const;
+
+    /**
+     * @return The number of bytes needed at the front of the buffer to complete the frame there, without validation.
+     */
+    std::size_t needed_() const noexcept;
+
+    socket_t* sock_;
+    frame_format format_;
+    std::vector<std::byte> buffer_;
+    std::size_t begin_{0U};
+    std::size_t end_{0U};
+  };
+
+  /**
+   * Sends frames on a TCP socket. Headers and payloads are passed to the kernel together in vectored sends, so
+   * payloads are never copied and a batch of frames costs a single native call per max_vectored_buffers/2 frames.
+   * @tparam TIP The IP version of the socket.
+   */
+  template<ip_version_t TIP>
+  class frame_writer final {
+  public:
+    using socket_t = socket<TIP, protocol_t::TCP>;
+
+    /**
+     * @param sock The socket to send to, which must outlive the writer.
+     * @param format The format of the frames.
+     */
+    explicit frame_writer(socket_t& sock, frame_format const& format = {});
+
+    /**
+     * Send a single frame, blocking until it was sent completely.
+     * @param payload The payload of the frame.
+     * @throws socket_error If the native send call fails.
+     * @throws frame_error If the payload is too large for the header.
+     */
+    void send(const_buffer payload);
+
+    /**
+     * Send several frames, blocking until all of them were sent completely.
+     * @param payloads The payloads of the frames in order.
+     * @throws socket_error If the native send call fails.
+     * @throws frame_error If a payload is too large for the header. Nothing is sent in that case.
+     */
+    void send(gsl::span<const_buffer const> payloads);
+
+  private:
+    socket_t* sock_;
+    frame_format format_;
+    std::vector<std::array<std::byte, 8U>> headers_{};
+    std::vector<const_buffer> buffers_{};
+  };
+
+  extern template
+  class frame_reader<ip_version_t::V4>;
+
+  extern template
+  class frame_reader<ip_version_t::V6>;
+
+  extern template
+  class frame_writer<ip_version_t::V4>;
+
+  extern template
+  class frame_writer<ip_version_t::V6>;
+}
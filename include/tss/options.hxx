@@ -0,0 +1,155 @@
+#pragma once
+
+#include "enums.hxx"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Typed socket options for use with set, get and apply of the sockets.
+ *
+ * Every option knows its value type and which IP versions and protocols it applies to, so setting e.g. tcp_nodelay on
+ * a UDP socket does not compile. Options not supported by the platform throw a socket_error with
+ * error_code::not_supported when used.
+ */
+namespace tss::options {
+  namespace detail {
+    template<option_t TId, typename TValue>
+    struct option {
+      using value_type = TValue;
+      static option_t constexpr id = TId;
+
+      value_type value;
+    };
+  }
+
+  /**
+   * SO_REUSEADDR: allow binding to an address still in use, e.g. by connections in TIME_WAIT.
+   */
+  struct reuse_addr final : detail::option<option_t::ReuseAddr, bool> {
+    template<ip_version_t, protocol_t>
+    static bool constexpr applies_to = true;
+  };
+
+  /**
+   * SO_REUSEPORT: allow several sockets to bind to the same address and share its traffic.
+   */
+  struct reuse_port final : detail::option<option_t::ReusePort, bool> {
+    template<ip_version_t, protocol_t>
+    static bool constexpr applies_to = true;
+  };
+
+  /**
+   * SO_SNDBUF: the size of the send buffer in bytes. Linux doubles the value to account for bookkeeping.
+   */
+  struct send_buffer_size final : detail::option<option_t::SendBufferSize, std::size_t> {
+    template<ip_version_t, protocol_t>
+    static bool constexpr applies_to = true;
+  };
+
+  /**
+   * SO_RCVBUF: the size of the receive buffer in bytes. Linux doubles the value to account for bookkeeping.
+   */
+  struct receive_buffer_size final : detail::option<option_t::ReceiveBufferSize, std::size_t> {
+    template<ip_version_t, protocol_t>
+    static bool constexpr applies_to = true;
+  };
+
+  /**
+   * SO_PRIORITY: the queueing priority of outgoing packets. Linux only.
+   */
+  struct priority final : detail::option<option_t::Priority, int> {
+    template<ip_version_t, protocol_t>
+    static bool constexpr applies_to = true;
+  };
+
+  /**
+   * SO_KEEPALIVE: probe idle connections to detect dead peers.
+   */
+  struct keep_alive final : detail::option<option_t::KeepAlive, bool> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::TCP;
+  };
+
+  /**
+   * TCP_NODELAY: send small segments immediately instead of coalescing them (Nagle's algorithm).
+   */
+  struct tcp_nodelay final : detail::option<option_t::TcpNoDelay, bool> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::TCP;
+  };
+
+  /**
+   * TCP_CORK: hold back partial segments until the cork is removed. Linux only.
+   */
+  struct tcp_cork final : detail::option<option_t::TcpCork, bool> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::TCP;
+  };
+
+  /**
+   * TCP_QUICKACK: acknowledge immediately instead of delaying. The kernel may reset it, so it is usually set again
+   * after every receive. Linux only.
+   */
+  struct tcp_quickack final : detail::option<option_t::TcpQuickAck, bool> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::TCP;
+  };
+
+  /**
+   * TCP_FASTOPEN: the length of the queue of pending TCP Fast Open requests on a listening socket.
+   */
+  struct tcp_fastopen final : detail::option<option_t::TcpFastOpen, std::uint32_t> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::TCP;
+  };
+
+  /**
+   * TCP_NOTSENT_LOWAT: report the socket writable only while less than this many bytes are not yet sent.
+   */
+  struct tcp_notsent_lowat final : detail::option<option_t::TcpNotSentLowAt, std::uint32_t> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::TCP;
+  };
+
+  /**
+   * UDP_SEGMENT: the segment size used to split large sends (GSO). Linux only.
+   */
+  struct udp_segment final : detail::option<option_t::UdpSegment, std::uint16_t> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::UDP;
+  };
+
+  /**
+   * UDP_GRO: coalesce received datagrams of the same flow (GRO). Linux only.
+   */
+  struct udp_gro final : detail::option<option_t::UdpGro, bool> {
+    template<ip_version_t, protocol_t TProto>
+    static bool constexpr applies_to = TProto==protocol_t::UDP;
+  };
+
+  /**
+   * IP_TOS: the type of service field of outgoing IPv4 packets.
+   */
+  struct ip_tos final : detail::option<option_t::IpTos, std::uint8_t> {
+    template<ip_version_t TIP, protocol_t>
+    static bool constexpr applies_to = TIP==ip_version_t::V4;
+  };
+
+  /**
+   * IPV6_V6ONLY: restrict an IPv6 socket to IPv6, instead of also accepting IPv4-mapped addresses.
+   */
+  struct ipv6_v6only final : detail::option<option_t::Ipv6V6Only, bool> {
+    template<ip_version_t TIP, protocol_t>
+    static bool constexpr applies_to = TIP==ip_version_t::V6;
+  };
+}
+
+namespace tss::concepts {
+  template<typename TOption, ip_version_t TIP, protocol_t TProto>
+  concept SocketOption = requires {
+    typename TOption::value_type;
+    { TOption::id } -> std::convertible_to<option_t>;
+  } && TOption::template applies_to<TIP, TProto>;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "concepts.hxx"
+#include "enums.hxx"
+#include "native.hxx"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include <gsl/span>
+
+namespace tss {
+  namespace detail {
+    struct poller_data;
+  }
+
+  /**
+   * Readiness notification mechanism with a persistent interest set.
+   *
+   * Unlike the selector, sockets stay registered across calls to wait and only the sockets that are actually ready
+   * are reported, so the cost of a wait does not grow with the number of registered sockets.
+   * Currently only available on Linux, where it is backed by epoll.
+   */
+  class poller final {
+    using traits = native::socket_traits;
+
+  public:
+    /**
+     * A socket that became ready during a call to wait.
+     */
+    struct event final {
+      traits::socket_t socket;
+      poll_event_t events;
+      void* user_data;
+
+      template<concepts::Socket TSocket>
+      [[nodiscard]] bool is(TSocket const& sock) const noexcept
+      {
+        return socket==sock.native_handle();
+      }
+
+      [[nodiscard]] bool is_read() const noexcept
+      {
+        return (events & poll_event_t::Read)!=poll_event_t::None;
+      }
+
+      [[nodiscard]] bool is_write() const noexcept
+      {
+        return (events & poll_event_t::Write)!=poll_event_t::None;
+      }
+
+      [[nodiscard]] bool is_error() const noexcept
+      {
+        return (events & poll_event_t::Error)!=poll_event_t::None;
+      }
+
+      [[nodiscard]] bool is_hang_up() const noexcept
+      {
+        return (events & poll_event_t::HangUp)!=poll_event_t::None;
+      }
+    };
+
+    /**
+     * Creates a new poller with an empty interest set.
+     * @param max_events The initial number of events a single call to wait can report.
+     * @throws socket_error If the native poller could not be created.
+     */
+    explicit poller(std::size_t max_events = 256U, native::socket_api const& = native::socket_api::instance());
+
+    poller(poller const&) = delete;
+
+    poller& operator=(poller const&) = delete;
+
+    /**
+     * The destructor closes the native poller. Registered sockets are not closed.
+     */
+    ~poller() noexcept;
+
+    /**
+     * Register a socket.
+     * @param sock The socket to watch.
+     * @param events The events to watch for. Errors and hang ups are always reported.
+     * @param user_data Arbitrary pointer reported back alongside the socket's events.
+     * @param trigger Whether readiness is reported as long as it persists, once per change or only once.
+     * @throws socket_error If the socket is already registered or cannot be watched.
+     */
+    template<concepts::Socket TSocket>
+    void add(TSocket const& sock, poll_event_t const events, void* const user_data = nullptr,
+        trigger_t const trigger = trigger_t::Level)
+    {
+      add_(sock.native_handle(), events, user_data, trigger);
+    }
+
+    /**
+     * Change the events and user data of an already registered socket.
+     * This also rearms sockets registered with trigger_t::OneShot.
+     * @throws socket_error If the socket is not registered.
+     */
+    template<concepts::Socket TSocket>
+    void modify(TSocket const& sock, poll_event_t const events, void* const user_data = nullptr,
+        trigger_t const trigger = trigger_t::Level)
+    {
+      modify_(sock.native_handle(), events, user_data, trigger);
+    }
+
+    /**
+     * Unregister a socket. Sockets must be removed before they are closed.
+     * @throws socket_error If the socket is not registered.
+     */
+    template<concepts::Socket TSocket>
+    void remove(TSocket const& sock)
+    {
+      remove_(sock.native_handle());
+    }
+
+    /**
+     * Wait for registered sockets to become ready.
+     * @param time_out How long to wait. A negative value waits until at least one socket is ready.
+     * @return The ready sockets. The span stays valid until the next call to wait.
+     *         It is empty if the time out expired or the wait was interrupted by a signal.
+     * @throws socket_error If the native wait call fails.
+     */
+    gsl::span<event const> wait(std::chrono::milliseconds time_out = std::chrono::milliseconds{0});
+
+    /**
+     * @return The number of currently registered sockets.
+     */
+    [[nodiscard]] std::size_t size() const noexcept;
+
+  private:
+    void add_(traits::socket_t sock, poll_event_t events, void* user_data, trigger_t trigger);
+
+    void modify_(traits::socket_t sock, poll_event_t events, void* user_data, trigger_t trigger);
+
+    void remove_(traits::socket_t sock);
+
+    std::unique_ptr<detail::poller_data> data_;
+  };
+}
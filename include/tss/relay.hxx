@@ -0,0 +1,84 @@
+#pragma once
+
+#include "enums.hxx"
+#include "socket.hxx"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tss {
+  namespace detail {
+    struct relay_data;
+  }
+
+  /**
+   * Forwards bytes between two connected TCP sockets in both directions without copying them to user space.
+   *
+   * Each direction moves its bytes with splice through its own pipe. Once a socket reports the end of its stream and
+   * everything it sent was forwarded, the other socket is shut down for writing, so half-closed connections are relayed
+   * faithfully. Both sockets are switched to non-blocking mode and must outlive the relay.
+   * Currently only available on Linux.
+   * @tparam TIP The IP version of the sockets.
+   */
+  template<ip_version_t TIP>
+  class relay final {
+  public:
+    /**
+     * Prepare forwarding between two sockets.
+     * @param first One of the sockets.
+     * @param second The other socket.
+     * @param pipe_size The requested capacity of each pipe in bytes. Zero keeps the system default.
+     * @throws socket_error If the sockets cannot be made non-blocking or the pipes cannot be created.
+     */
+    relay(socket<TIP, protocol_t::TCP>& first, socket<TIP, protocol_t::TCP>& second, std::size_t pipe_size = 0U);
+
+    relay(relay const&) = delete;
+
+    relay& operator=(relay const&) = delete;
+
+    ~relay() noexcept;
+
+    /**
+     * Forward whatever can be forwarded without blocking.
+     * @return The number of bytes forwarded in both directions.
+     * @throws socket_error If a native splice or shutdown call fails.
+     */
+    std::size_t pump();
+
+    /**
+     * Forward until both directions reached the end of their stream or the time out expired.
+     * @param time_out How long to wait for progress. A negative value waits until the relay is done.
+     * @return true, if the relay is done, false otherwise.
+     * @throws socket_error If a native splice, shutdown or epoll call fails.
+     */
+    bool run(std::chrono::milliseconds time_out = std::chrono::milliseconds{-1});
+
+    /**
+     * @return true, if both directions reached the end of their stream and everything was forwarded.
+     */
+    [[nodiscard]] bool is_done() const noexcept;
+
+    /**
+     * @return The number of bytes forwarded from the first to the second socket.
+     */
+    [[nodiscard]] std::uint64_t first_to_second() const noexcept;
+
+    /**
+     * @return The number of bytes forwarded from the second to the first socket.
+     */
+    [[nodiscard]] std::uint64_t second_to_first() const noexcept;
+
+  private:
+    socket<TIP, protocol_t::TCP>& first_;
+    socket<TIP, protocol_t::TCP>& second_;
+    std::unique_ptr<detail::relay_data> data_;
+  };
+
+  extern template
+  class relay<ip_version_t::V4>;
+
+  extern template
+  class relay<ip_version_t::V6>;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "address.hxx"
+#include "native.hxx"
+
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <gsl/span>
+
+namespace tss {
+  namespace detail {
+    struct resolver_data;
+  }
+
+  /**
+   * Resolves host names on a pool of worker threads and caches the results.
+   *
+   * Lookups return immediately with a future, so the calling thread never waits for the system resolver.
+   * Concurrent lookups of the same name share a single query, results stay cached for a fixed time and duplicate
+   * addresses are removed. Failed lookups are not cached. Lookups still pending when the resolver is destroyed fail
+   * with a broken promise.
+   */
+  class resolver final {
+  public:
+    using v4_addresses_t = std::vector<ip_address_v4_t>;
+    using v6_addresses_t = std::vector<ip_address_v6_t>;
+    using addresses_t = std::vector<std::variant<ip_address_v4_t, ip_address_v6_t>>;
+
+    /**
+     * Start the worker threads.
+     * @param threads The number of lookups that may run in parallel.
+     * @param time_to_live How long results stay cached.
+     */
+    explicit resolver(
+        std::size_t threads = 4U,
+        std::chrono::seconds time_to_live = std::chrono::seconds{60},
+        native::socket_api const& = native::socket_api::instance()
+    );
+
+    resolver(resolver const&) = delete;
+
+    resolver& operator=(resolver const&) = delete;
+
+    /**
+     * Stop the worker threads after the lookups currently running finished.
+     */
+    ~resolver() noexcept;
+
+    /**
+     * Look up the IPv4 addresses of a host.
+     * @param host The host name or a textual IPv4 address.
+     * @return The distinct addresses in the order reported by the system, or an address_info_error.
+     */
+    [[nodiscard]] std::shared_future<v4_addresses_t> resolve_v4(std::string_view host);
+
+    /**
+     * Look up the IPv6 addresses of a host.
+     * @param host The host name or a textual IPv6 address.
+     * @return The distinct addresses in the order reported by the system, or an address_info_error.
+     */
+    [[nodiscard]] std::shared_future<v6_addresses_t> resolve_v6(std::string_view host);
+
+    /**
+     * Look up the addresses of a host of both IP versions.
+     * @param host The host name or a textual IP address.
+     * @return The distinct addresses in the order reported by the system, or an address_info_error.
+     */
+    [[nodiscard]] std::shared_future<addresses_t> resolve(std::string_view host);
+
+    /**
+     * Look up the addresses of many hosts in parallel.
+     * @param hosts The host names or textual IP addresses.
+     * @return One future per host, in the same order.
+     */
+    [[nodiscard]] std::vector<std::shared_future<addresses_t>> resolve(gsl::span<std::string_view const> hosts);
+
+    /**
+     * Drop all cached results whose time to live expired.
+     */
+    void purge();
+
+    /**
+     * Drop all cached results. Pending lookups still complete.
+     */
+    void clear();
+
+    /**
+     * @return The number of cached or pending lookups.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    std::unique_ptr<detail::resolver_data> data_;
+  };
+}
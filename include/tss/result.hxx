@@ -0,0 +1,123 @@
+#pragma once
+
+#include "exceptions.hxx"
+
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace tss {
+  /**
+   * Either the value produced by a native socket call or the error code it failed with.
+   * Returned by the non-throwing overloads, which are selected by passing std::nothrow as first argument.
+   * @tparam T The type of the value. Can be void for calls that produce nothing.
+   */
+  template<typename T>
+  class [[nodiscard]] result final {
+    using value_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+  public:
+    template<typename... TArgs>
+    requires std::is_constructible_v<value_t, TArgs...>
+    result(TArgs&& ... args) noexcept(std::is_nothrow_constructible_v<value_t, TArgs...>)
+        :storage_{std::in_place_index<0U>, std::forward<TArgs>(args)...}
+    {
+    }
+
+    result(error_code const error) noexcept
+        :storage_{std::in_place_index<1U>, error}
+    {
+    }
+
+    [[nodiscard]] bool has_value() const noexcept
+    {
+      return storage_.index()==0U;
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept
+    {
+      return has_value();
+    }
+
+    /**
+     * Access the value.
+     * @throws socket_error If the call failed.
+     */
+    decltype(auto) value() &
+    {
+      throw_if_error();
+      if constexpr (!std::is_void_v<T>) {
+        return *std::get_if<0U>(&storage_);
+      }
+    }
+
+    decltype(auto) value() const&
+    {
+      throw_if_error();
+      if constexpr (!std::is_void_v<T>) {
+        return *std::get_if<0U>(&storage_);
+      }
+    }
+
+    decltype(auto) value() &&
+    {
+      throw_if_error();
+      if constexpr (!std::is_void_v<T>) {
+        return std::move(*std::get_if<0U>(&storage_));
+      }
+    }
+
+    template<typename TSelf = T>
+    requires (!std::is_void_v<TSelf>)
+    TSelf& operator*() & noexcept
+    {
+      return *std::get_if<0U>(&storage_);
+    }
+
+    template<typename TSelf = T>
+    requires (!std::is_void_v<TSelf>)
+    TSelf const& operator*() const& noexcept
+    {
+      return *std::get_if<0U>(&storage_);
+    }
+
+    template<typename TSelf = T>
+    requires (!std::is_void_v<TSelf>)
+    TSelf&& operator*() && noexcept
+    {
+      return std::move(*std::get_if<0U>(&storage_));
+    }
+
+    template<typename TSelf = T>
+    requires (!std::is_void_v<TSelf>)
+    TSelf* operator->() noexcept
+    {
+      return std::get_if<0U>(&storage_);
+    }
+
+    template<typename TSelf = T>
+    requires (!std::is_void_v<TSelf>)
+    TSelf const* operator->() const noexcept
+    {
+      return std::get_if<0U>(&storage_);
+    }
+
+    /**
+     * Access the error code. Must only be called if the call failed.
+     */
+    [[nodiscard]] error_code error() const noexcept
+    {
+      return *std::get_if<1U>(&storage_);
+    }
+
+  private:
+    void throw_if_error() const
+    {
+      if (auto const* const error = std::get_if<1U>(&storage_); error!=nullptr) {
+        throw socket_error{error->value()};
+      }
+    }
+
+    std::variant<value_t, error_code> storage_;
+  };
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "address.hxx"
+#include "enums.hxx"
+#include "socket.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tss {
+  /**
+   * How the kernel picks the shard for a new connection or datagram.
+   */
+  enum class steering_t : std::uint8_t {
+    /**
+     * Spread by a hash over the addresses of the flow, the kernel default.
+     */
+    Hash,
+
+    /**
+     * Use the shard matching the CPU that received the flow, modulo the number of shards.
+     * Pays off when the thread serving shard i is pinned to CPU i, see pin_current_thread.
+     */
+    Cpu,
+  };
+
+  /**
+   * Several sockets bound to the same address with SO_REUSEPORT, one per worker thread.
+   *
+   * The kernel distributes incoming connections (TCP) or datagrams (UDP) across the shards, so each worker accepts or
+   * receives on its own socket without contending with the others.
+   * Currently only available on Linux.
+   * @tparam TIP The IP version of the sockets.
+   * @tparam TProto The protocol of the sockets.
+   */
+  template<ip_version_t TIP, protocol_t TProto>
+  class sharded_listener final {
+  public:
+    using socket_t = socket<TIP, TProto>;
+
+    /**
+     * Create, bind and, for TCP, start listening on all shards.
+     * @param address The address all shards bind to.
+     * @param shards The number of sockets to create. Must not be zero.
+     * @param steering How flows are assigned to shards.
+     * @param backlog The maximum number of queued connections per shard. Ignored for UDP.
+     * @throws socket_error If a native call fails, e.g. because the steering program is rejected.
+     */
+    sharded_listener(
+        address_t<TIP> const& address,
+        std::size_t shards,
+        steering_t steering = steering_t::Hash,
+        std::uint32_t backlog = 128U
+    );
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+      return shards_.size();
+    }
+
+    socket_t& operator[](std::size_t const index) noexcept
+    {
+      return shards_[index];
+    }
+
+    socket_t const& operator[](std::size_t const index) const noexcept
+    {
+      return shards_[index];
+    }
+
+    [[nodiscard]] auto begin() noexcept
+    {
+      return shards_.begin();
+    }
+
+    [[nodiscard]] auto end() noexcept
+    {
+      return shards_.end();
+    }
+
+  private:
+    std::vector<socket_t> shards_;
+  };
+
+  /**
+   * Restrict the calling thread to a single CPU.
+   * @param cpu The index of the CPU.
+   * @throws socket_error If the native pthread_setaffinity_np call fails.
+   */
+  void pin_current_thread(std::size_t cpu);
+
+  extern template
+  class sharded_listener<ip_version_t::V4, protocol_t::TCP>;
+
+  extern template
+  class sharded_listener<ip_version_t::V4, protocol_t::UDP>;
+
+  extern template
+  class sharded_listener<ip_version_t::V6, protocol_t::TCP>;
+
+  extern template
+  class sharded_listener<ip_version_t::V6, protocol_t::UDP>;
+}
@@ -1,14 +1,80 @@
 #pragma once
 
 #include "address.hxx"
+#include "buffer.hxx"
+#include "buffer_pool.hxx"
 #include "concepts.hxx"
 #include "enums.hxx"
 #include "native.hxx"
+#include "options.hxx"
+#include "result.hxx"
+#include "stats.hxx"
 
 #include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#include <gsl/span>
 
 namespace tss {
+  class uring_engine;
+
+  /**
+   * Kernel timestamps of a packet, see socket_base::set_timestamping.
+   */
+  struct timestamps final {
+    /**
+     * Taken by the kernel, relative to the Unix epoch like std::chrono::system_clock.
+     */
+    std::optional<std::chrono::nanoseconds> software;
+
+    /**
+     * Taken by the network card, relative to the epoch of its own clock.
+     */
+    std::optional<std::chrono::nanoseconds> hardware;
+  };
+
+  /**
+   * The outcome of receive_timestamped.
+   */
+  struct timestamped_receive final {
+    /**
+     * The number of bytes received.
+     */
+    std::size_t length;
+
+    /**
+     * When the (last) packet of the received data arrived.
+     */
+    timestamps time;
+  };
+
+  /**
+   * A transmit timestamp reported by receive_tx_timestamps.
+   */
+  struct tx_timestamp final {
+    /**
+     * Identifies the send: the number of datagrams sent before it for UDP, the number of bytes sent up to and
+     * including it for TCP, both counted from enabling transmit timestamps.
+     */
+    std::uint32_t id;
+
+    /**
+     * The point on the transmit path the timestamp was taken at.
+     */
+    tx_stage_t stage;
+
+    timestamps time;
+  };
+
   namespace detail {
     template<ip_version_t TIP, protocol_t TProto>
     class socket_base : public native::socket {
@@ -19,6 +85,18 @@ namespace tss {
        */
       explicit socket_base(native::socket_api const& = native::socket_api::instance());
 
+      /**
+       * Constructs a socket and applies the given options, see apply.
+       * @throws socket_error If the native socket or setsockopt call fails.
+       */
+      template<typename ... TOptions>
+      requires (sizeof...(TOptions)>0U && (concepts::SocketOption<TOptions, TIP, TProto> && ...))
+      explicit socket_base(TOptions const& ... options)
+          :socket_base{}
+      {
+        apply(options...);
+      }
+
       /**
        * Move constructs a socket making the original socket invalid.
        * @param src The original socket.
@@ -84,11 +162,128 @@ namespace tss {
        */
       [[nodiscard]] bool get_reuse_addr() const;
 
+      /**
+       * Allow several sockets to bind to the same address, so the kernel spreads connections or datagrams across them.
+       * @param reuse Whether sharing the same address should be allowed.
+       * @throws socket_error If the native setsockopt call fails or the platform does not support SO_REUSEPORT.
+       */
+      void set_reuse_port(bool reuse = true);
+
+      /**
+       * Check whether sharing the same address is currently allowed.
+       * @return true, if sharing the address is currently allowed, false otherwise.
+       * @throws socket_error If the native getsockopt call fails or the platform does not support SO_REUSEPORT.
+       */
+      [[nodiscard]] bool get_reuse_port() const;
+
+      /**
+       * Switch between blocking and non-blocking mode.
+       * In non-blocking mode calls that would have to wait fail with an error code for which
+       * error_code::would_block returns true, which is best handled using the std::nothrow overloads.
+       * @param non_blocking Whether the socket should be non-blocking.
+       * @throws socket_error If the native fcntl or ioctlsocket call fails.
+       */
+      void set_non_blocking(bool non_blocking = true);
+
+      /**
+       * Set a socket option.
+       * @tparam TOption The option from tss::options, which must apply to the IP version and protocol of the socket.
+       * @param value The new value of the option.
+       * @throws socket_error If the value does not fit into the int taken by the native setsockopt call, the call fails
+       * or the platform does not support the option.
+       */
+      template<typename TOption>
+      requires concepts::SocketOption<TOption, TIP, TProto>
+      void set(typename TOption::value_type const value)
+      {
+        if constexpr (!std::is_same_v<typename TOption::value_type, bool>) {
+          if (!std::in_range<int>(value)) {
+            throw socket_error{error_code::invalid_argument().value()};
+          }
+        }
+        set_option_(TOption::id, static_cast<int>(value));
+      }
+
+      /**
+       * Get the current value of a socket option.
+       * @tparam TOption The option from tss::options, which must apply to the IP version and protocol of the socket.
+       * @return The current value of the option.
+       * @throws socket_error If the native getsockopt call fails or the platform does not support the option.
+       */
+      template<typename TOption>
+      requires concepts::SocketOption<TOption, TIP, TProto>
+      [[nodiscard]] typename TOption::value_type get() const
+      {
+        return static_cast<typename TOption::value_type>(get_option_(TOption::id));
+      }
+
+      /**
+       * Set several socket options in order, e.g. apply(options::tcp_nodelay{true}, options::send_buffer_size{1U << 20U}).
+       * @param options The options with their new values.
+       * @throws socket_error If a native setsockopt call fails, leaving the options after the failing one unchanged.
+       */
+      template<typename ... TOptions>
+      requires (concepts::SocketOption<TOptions, TIP, TProto> && ...)
+      void apply(TOptions const& ... options)
+      {
+        (set<TOptions>(options.value), ...);
+      }
+
+      /**
+       * Enable kernel timestamps for received and sent packets (SO_TIMESTAMPING). Only available on Linux.
+       *
+       * Receive timestamps are returned by receive_timestamped, transmit timestamps are queued until
+       * receive_tx_timestamps picks them up. Hardware timestamps additionally require a network card that supports them
+       * with timestamping enabled on the interface (SIOCSHWTSTAMP). The kernel turns on receive timestamps
+       * asynchronously, so packets arriving right after the first socket of the process enabled them may lack one.
+       * @param flags Which timestamps to generate, None disables timestamping.
+       * @throws socket_error If the native setsockopt call fails or timestamping is not supported.
+       */
+      void set_timestamping(timestamping_t flags);
+
+      /**
+       * Pick up queued transmit timestamps without blocking.
+       * The error queue is shared with zero_copy_sender, so both should not be used on the same socket.
+       * @param reports The buffer receiving the timestamps.
+       * @return The number of timestamps written to reports.
+       * @throws socket_error If the native recvmsg call fails.
+       */
+      std::size_t receive_tx_timestamps(gsl::span<tx_timestamp> reports);
+
+      result<std::size_t> receive_tx_timestamps(std::nothrow_t, gsl::span<tx_timestamp> reports) noexcept;
+
+      /**
+       * Take a snapshot of the calls made on this socket, see global_stats for all sockets.
+       * @return The statistics, which stay zero unless the library was built with TSS_WITH_STATS.
+       */
+      [[nodiscard]] io_stats stats() const noexcept;
+
     protected:
       using traits = native::socket_traits;
       traits::socket_t handle_;
+      [[no_unique_address]] stats_policy::counters stats_{};
+
+      /**
+       * Receive along with the receive timestamps of the data.
+       */
+      result<timestamped_receive>
+      receive_timestamped_(address_t<TIP>* address, std::byte* buffer, std::size_t buffer_length) noexcept;
+
+      void set_option_(option_t option, int value);
+
+      [[nodiscard]] int get_option_(option_t option) const;
 
       explicit socket_base(traits::socket_t handle) noexcept;
+
+      /**
+       * Send to the peer of a connected socket.
+       */
+      result<std::size_t> send_(std::byte const* data, std::size_t data_length) noexcept;
+
+      /**
+       * Receive from the peer of a connected socket.
+       */
+      result<std::size_t> receive_(std::byte* buffer, std::size_t buffer_length) noexcept;
     };
 
     extern template
@@ -112,6 +307,12 @@ namespace tss {
     using base_t = detail::socket_base<TIP, protocol_t::TCP>;
     using traits = native::socket_traits;
     using base_t::handle_;
+    using base_t::stats_;
+    using base_t::send_;
+    using base_t::receive_;
+    using base_t::receive_timestamped_;
+
+    friend class uring_engine;
 
   public:
     using base_t::base_t;
@@ -133,6 +334,14 @@ namespace tss {
      */
     void connect(tss::address_t<TIP> const& address);
 
+    /**
+     * Establish a connection to a server without throwing.
+     * On a non-blocking socket the error code reports in_progress while the connection is being established.
+     * @param address The address of the server consisting of IP address and port number.
+     * @return Nothing or the error code of the native connect call.
+     */
+    result<void> connect(std::nothrow_t, tss::address_t<TIP> const& address) noexcept;
+
     /**
      * Accept a connection.
      * @param address The address of the connecting client. Can be nullptr if irrelevant.
@@ -141,6 +350,30 @@ namespace tss {
      */
     socket accept(address_t<TIP>* address);
 
+    /**
+     * Accept a connection without throwing.
+     * @param address The address of the connecting client. Can be nullptr if irrelevant.
+     * @return The socket for the new connection or the error code of the native accept call.
+     */
+    result<socket> accept(std::nothrow_t, address_t<TIP>* address) noexcept;
+
+    /**
+     * Accept all pending connections, up to a limit, e.g. after the poller reported the socket readable.
+     *
+     * The new sockets are non-blocking and not inherited by child processes. On Linux both are set by accept4 within
+     * the same call, elsewhere they need an additional call per connection.
+     * Meant for non-blocking sockets, since on a blocking socket every accept waits for the next connection.
+     * @param max The maximum number of connections to accept.
+     * @param sockets The sockets for the new connections are appended to this.
+     * @param addresses The addresses of the connecting clients are appended to this. Can be nullptr if irrelevant.
+     * @return The number of accepted connections, which is zero if none are pending.
+     * Connections aborted by the client before they were accepted are skipped.
+     * @throws socket_error If the native accept call fails for the first connection. Errors of the listener after that
+     * end the batch and are reported again by the next call.
+     */
+    std::size_t
+    accept_many(std::size_t max, std::vector<socket>& sockets, std::vector<address_t<TIP>>* addresses = nullptr);
+
     /**
      * Shuts down all or part of a full-duplex connection.
      * @param how Which parts to shut down.
@@ -156,7 +389,21 @@ namespace tss {
      * @throws socket_error If the native send call fails.
      */
     template<concepts::Data TData>
+    requires (!concepts::View<TData>)
     std::size_t send(TData const& data)
+    {
+      return send_(reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData)).value();
+    }
+
+    /**
+     * Send data to the connected peer without throwing.
+     * @tparam TData The type of data to send.
+     * @param data The data to send.
+     * @return The number of bytes actually transmitted or the error code of the native send call.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    result<std::size_t> send(std::nothrow_t, TData const& data) noexcept
     {
       return send_(reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData));
     }
@@ -169,22 +416,314 @@ namespace tss {
      * @throws socket_error If the native recv call fails.
      */
     template<concepts::Data TData>
+    requires (!concepts::View<TData>)
     std::size_t receive(TData& buffer)
+    {
+      return receive_(reinterpret_cast<std::byte*>(std::addressof(buffer)), sizeof(TData)).value();
+    }
+
+    /**
+     * Receive data from the connected peer without throwing.
+     * @tparam TData The type of data to receive.
+     * @param buffer The buffer receiving the incoming data.
+     * @return The number of bytes actually received or the error code of the native recv call.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    result<std::size_t> receive(std::nothrow_t, TData& buffer) noexcept
     {
       return receive_(reinterpret_cast<std::byte*>(std::addressof(buffer)), sizeof(TData));
     }
 
+    /**
+     * Send a contiguous sequence of elements to the connected peer using a single native call.
+     * @tparam TData The type of the elements to send.
+     * @param data The elements to send.
+     * @return The number of bytes actually transmitted, which may be less than the size of all elements.
+     * @throws socket_error If the native send call fails.
+     */
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t send(gsl::span<TData, TExtent> const data)
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    result<std::size_t> send(std::nothrow_t, gsl::span<TData, TExtent> const data) noexcept
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t send(std::span<TData, TExtent> const data)
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    result<std::size_t> send(std::nothrow_t, std::span<TData, TExtent> const data) noexcept
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    /**
+     * Receive into a contiguous sequence of elements using a single native call.
+     * @tparam TData The type of the elements to receive.
+     * @param buffer The elements receiving the incoming data.
+     * @return The number of bytes actually received, which may end in the middle of an element.
+     * @throws socket_error If the native recv call fails.
+     */
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive(gsl::span<TData, TExtent> const buffer)
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    result<std::size_t> receive(std::nothrow_t, gsl::span<TData, TExtent> const buffer) noexcept
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive(std::span<TData, TExtent> const buffer)
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    result<std::size_t> receive(std::nothrow_t, std::span<TData, TExtent> const buffer) noexcept
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+    /**
+     * Receive into a buffer borrowed from a pool, so memory is only held while data is actually pending.
+     * Meant for non-blocking sockets reported readable by a poller, as a blocking call holds the buffer while waiting.
+     * @param pool The pool to borrow the buffer from.
+     * @return The buffer sized to the bytes received, or an empty buffer at the end of the stream.
+     * @throws socket_error If the native recv call fails or the pool has no buffer left.
+     */
+    pooled_buffer receive(buffer_pool& pool);
+
+    result<pooled_buffer> receive(std::nothrow_t, buffer_pool& pool) noexcept;
+
+    /**
+     * Send data to the connected peer, retrying until everything was transmitted.
+     * Meant for blocking sockets, as a non-blocking socket fails as soon as its send buffer is full.
+     * @tparam TData The type of data to send.
+     * @param data The data to send.
+     * @throws socket_error If a native send call fails.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    void send_all(TData const& data)
+    {
+      send_all_(reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    void send_all(gsl::span<TData, TExtent> const data)
+    {
+      send_all_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    void send_all(std::span<TData, TExtent> const data)
+    {
+      send_all_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    /**
+     * Receive data from the connected peer, retrying until the buffer is completely filled.
+     * Meant for blocking sockets, as a non-blocking socket fails as soon as no more data is available.
+     * @tparam TData The type of data to receive.
+     * @param buffer The buffer receiving the incoming data.
+     * @return The number of bytes actually received. It is only less than the size of the buffer,
+     *         if the peer shut down the connection before sending enough data.
+     * @throws socket_error If a native recv call fails.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    std::size_t receive_exact(TData& buffer)
+    {
+      return receive_exact_(reinterpret_cast<std::byte*>(std::addressof(buffer)), sizeof(TData));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive_exact(gsl::span<TData, TExtent> const buffer)
+    {
+      return receive_exact_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive_exact(std::span<TData, TExtent> const buffer)
+    {
+      return receive_exact_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+    /**
+     * Send several buffers to the connected peer using a single native call, without copying them together first.
+     * At most max_vectored_buffers are sent per call.
+     * @param buffers The buffers to send in order.
+     * @return How far the transmission got. Use remaining_buffers to resume a short send.
+     * @throws socket_error If the native sendmsg call fails.
+     */
+    vectored_progress send_vectored(gsl::span<const_buffer const> buffers);
+
+    result<vectored_progress> send_vectored(std::nothrow_t, gsl::span<const_buffer const> buffers) noexcept;
+
+    /**
+     * Receive into several buffers using a single native call.
+     * At most max_vectored_buffers are filled per call.
+     * @param buffers The buffers to fill in order.
+     * @return How far the reception got. Use remaining_buffers to resume a short receive.
+     * @throws socket_error If the native recvmsg call fails.
+     */
+    vectored_progress receive_vectored(gsl::span<mutable_buffer const> buffers);
+
+    result<vectored_progress> receive_vectored(std::nothrow_t, gsl::span<mutable_buffer const> buffers) noexcept;
+
+    /**
+     * Receive data along with kernel timestamps, see set_timestamping.
+     * On platforms without timestamping this is a plain receive reporting no timestamps.
+     * @param buffer The buffer receiving the incoming data.
+     * @return The number of bytes received and when the last of them arrived.
+     * @throws socket_error If the native recvmsg call fails.
+     */
+    timestamped_receive receive_timestamped(mutable_buffer const buffer)
+    {
+      return receive_timestamped_(nullptr, buffer.data(), buffer.size()).value();
+    }
+
+    result<timestamped_receive> receive_timestamped(std::nothrow_t, mutable_buffer const buffer) noexcept
+    {
+      return receive_timestamped_(nullptr, buffer.data(), buffer.size());
+    }
+
+    /**
+     * Transmit part of a file straight from the page cache, without copying it through user space.
+     * Partial transfers are resumed until length bytes were sent or the end of the file was reached.
+     * A non-blocking socket stops early once its send buffer is full and reports the bytes sent so far.
+     * Uses sendfile on Linux and falls back to reading the file on other POSIX systems.
+     * @param file The descriptor of a file opened for reading. Its file offset is not changed.
+     * @param offset The position of the first byte to send.
+     * @param length The number of bytes to send. Defaults to everything up to the end of the file.
+     * @return The number of bytes actually transmitted.
+     * @throws socket_error If nothing could be sent or the native sendfile call fails.
+     */
+    std::size_t send_file(
+        int file,
+        std::uint64_t offset = 0U,
+        std::size_t length = std::numeric_limits<std::size_t>::max()
+    );
+
+    result<std::size_t> send_file(
+        std::nothrow_t,
+        int file,
+        std::uint64_t offset = 0U,
+        std::size_t length = std::numeric_limits<std::size_t>::max()
+    ) noexcept;
+
+    /**
+     * Open a file and transmit part of it, see the overload taking a file descriptor.
+     * @throws socket_error If the file cannot be opened, nothing could be sent or the native sendfile call fails.
+     */
+    std::size_t send_file(
+        std::filesystem::path const& path,
+        std::uint64_t offset = 0U,
+        std::size_t length = std::numeric_limits<std::size_t>::max()
+    );
+
   private:
-    std::size_t send_(std::byte const* data, std::size_t data_length);
+    void send_all_(std::byte const* data, std::size_t data_length);
+
+    std::size_t receive_exact_(std::byte* buffer, std::size_t buffer_length);
+  };
+
+  /**
+   * A datagram to be sent by send_batch.
+   */
+  template<ip_version_t TIP>
+  struct outgoing_datagram final {
+    const_buffer buffer;
+    address_t<TIP> address;
+  };
+
+  /**
+   * A datagram to be filled by receive_batch.
+   */
+  template<ip_version_t TIP>
+  struct incoming_datagram final {
+    /**
+     * The buffer receiving the payload. Longer datagrams are truncated.
+     */
+    mutable_buffer buffer;
+
+    /**
+     * The number of bytes received.
+     */
+    std::size_t length;
 
-    std::size_t receive_(std::byte* buffer, std::size_t buffer_length);
+    /**
+     * The sender address.
+     */
+    address_t<TIP> address;
   };
 
+  /**
+   * A datagram received by receive_batch into a buffer borrowed from a pool.
+   */
+  template<ip_version_t TIP>
+  struct pooled_datagram final {
+    /**
+     * The buffer holding the payload, sized to the bytes received.
+     */
+    pooled_buffer buffer;
+
+    /**
+     * The sender address.
+     */
+    address_t<TIP> address;
+  };
+
+  /**
+   * The outcome of receive_coalesced. Use segments to iterate the individual datagrams.
+   */
+  struct coalesced_datagram final {
+    /**
+     * The total number of bytes received.
+     */
+    std::size_t length;
+
+    /**
+     * The size of every coalesced datagram but the last. Equals length if nothing was coalesced, but is at least one,
+     * so an empty datagram can be passed to segments as well.
+     */
+    std::size_t segment_size;
+  };
+
+  /**
+   * The maximum number of datagrams transferred by a single batched send or receive.
+   */
+  std::size_t constexpr max_batched_datagrams{64U};
+
+  template<ip_version_t TIP>
+  class connected_udp_socket;
+
   template<ip_version_t TIP>
   class socket<TIP, protocol_t::UDP> final : public detail::socket_base<TIP, protocol_t::UDP> {
     using base_t = detail::socket_base<TIP, protocol_t::UDP>;
     using traits = native::socket_traits;
     using base_t::handle_;
+    using base_t::stats_;
+    using base_t::receive_timestamped_;
 
   public:
     using base_t::base_t;
@@ -201,7 +740,22 @@ namespace tss {
      * @throws socket_error If the native sendto call fails.
      */
     template<concepts::Data TData>
+    requires (!concepts::View<TData>)
     std::size_t send_to(address_t<TIP> const& address, TData const& data)
+    {
+      return send_to_(address, reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData)).value();
+    }
+
+    /**
+     * Send data to the given address without throwing.
+     * @tparam TData The type of data to send.
+     * @param address The target address consisting of an IP address and a port number.
+     * @param data The data to send.
+     * @return The number of bytes actually transmitted or the error code of the native sendto call.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    result<std::size_t> send_to(std::nothrow_t, address_t<TIP> const& address, TData const& data) noexcept
     {
       return send_to_(address, reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData));
     }
@@ -215,15 +769,358 @@ namespace tss {
      * @throws socket_error If the native recvfrom call fails.
      */
     template<concepts::Data TData>
+    requires (!concepts::View<TData>)
     std::size_t receive_from(address_t<TIP>* address, TData& buffer)
+    {
+      return receive_from_(address, reinterpret_cast<std::byte*>(std::addressof(buffer)), sizeof(TData)).value();
+    }
+
+    /**
+     * Receive data from somewhere without throwing.
+     * @tparam TData The type of data to receive.
+     * @param address The sender address. Can be nullptr if irrelevant.
+     * @param buffer The buffer receiving the incoming data.
+     * @return The number of bytes actually received or the error code of the native recvfrom call.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    result<std::size_t> receive_from(std::nothrow_t, address_t<TIP>* address, TData& buffer) noexcept
     {
       return receive_from_(address, reinterpret_cast<std::byte*>(std::addressof(buffer)), sizeof(TData));
     }
 
+    /**
+     * Send a contiguous sequence of elements as a single datagram to the given address.
+     * @tparam TData The type of the elements to send.
+     * @param address The target address consisting of an IP address and a port number.
+     * @param data The elements to send.
+     * @return The number of bytes actually transmitted.
+     * @throws socket_error If the native sendto call fails.
+     */
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t send_to(address_t<TIP> const& address, gsl::span<TData, TExtent> const data)
+    {
+      return send_to_(address, reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    result<std::size_t>
+    send_to(std::nothrow_t, address_t<TIP> const& address, gsl::span<TData, TExtent> const data) noexcept
+    {
+      return send_to_(address, reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t send_to(address_t<TIP> const& address, std::span<TData, TExtent> const data)
+    {
+      return send_to_(address, reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    result<std::size_t>
+    send_to(std::nothrow_t, address_t<TIP> const& address, std::span<TData, TExtent> const data) noexcept
+    {
+      return send_to_(address, reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    /**
+     * Receive a single datagram into a contiguous sequence of elements.
+     * @tparam TData The type of the elements to receive.
+     * @param address The sender address. Can be nullptr if irrelevant.
+     * @param buffer The elements receiving the incoming data.
+     * @return The number of bytes actually received.
+     * @throws socket_error If the native recvfrom call fails.
+     */
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive_from(address_t<TIP>* address, gsl::span<TData, TExtent> const buffer)
+    {
+      return receive_from_(address, reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    result<std::size_t>
+    receive_from(std::nothrow_t, address_t<TIP>* address, gsl::span<TData, TExtent> const buffer) noexcept
+    {
+      return receive_from_(address, reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive_from(address_t<TIP>* address, std::span<TData, TExtent> const buffer)
+    {
+      return receive_from_(address, reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    result<std::size_t>
+    receive_from(std::nothrow_t, address_t<TIP>* address, std::span<TData, TExtent> const buffer) noexcept
+    {
+      return receive_from_(address, reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+    /**
+     * Receive a single datagram into a buffer borrowed from a pool, so memory is only held while data is actually
+     * pending. Meant for non-blocking sockets reported readable by a poller. Longer datagrams are truncated.
+     * @param address The sender address. Can be nullptr if irrelevant.
+     * @param pool The pool to borrow the buffer from.
+     * @return The buffer sized to the bytes received.
+     * @throws socket_error If the native recvfrom call fails or the pool has no buffer left.
+     */
+    pooled_buffer receive_from(address_t<TIP>* address, buffer_pool& pool);
+
+    result<pooled_buffer> receive_from(std::nothrow_t, address_t<TIP>* address, buffer_pool& pool) noexcept;
+
+    /**
+     * Fix the peer of this socket, so datagrams no longer need an address and datagrams from other senders are dropped.
+     * Consumes the socket, as a connected socket only supports plain send and receive.
+     * @param address The address of the peer consisting of IP address and port number.
+     * @return The connected socket.
+     * @throws socket_error If the native connect call fails.
+     */
+    connected_udp_socket<TIP> connect(address_t<TIP> const& address) &&;
+
+    /**
+     * Send several datagrams, each to its own address, using a single native call where available.
+     * At most max_batched_datagrams are sent per call.
+     * @param datagrams The datagrams to send in order.
+     * @return The number of datagrams actually sent, which is at least one.
+     * @throws socket_error If the native sendmmsg call fails.
+     */
+    std::size_t send_batch(gsl::span<outgoing_datagram<TIP> const> datagrams);
+
+    result<std::size_t> send_batch(std::nothrow_t, gsl::span<outgoing_datagram<TIP> const> datagrams) noexcept;
+
+    /**
+     * Receive several datagrams using a single native call where available.
+     * Waits for the first datagram only and then takes whatever else is already queued,
+     * up to max_batched_datagrams. Fills in length and address of every received datagram.
+     * @param datagrams The datagrams to fill in order.
+     * @return The number of datagrams actually received, which is at least one.
+     * @throws socket_error If the native recvmmsg call fails.
+     */
+    std::size_t receive_batch(gsl::span<incoming_datagram<TIP>> datagrams);
+
+    result<std::size_t> receive_batch(std::nothrow_t, gsl::span<incoming_datagram<TIP>> datagrams) noexcept;
+
+    /**
+     * Receive several datagrams into buffers borrowed from a pool, see receive_batch above.
+     * One buffer is borrowed per slot and those left unused are returned right away, so size the span to the bursts
+     * expected rather than to max_batched_datagrams.
+     * @param pool The pool to borrow the buffers from.
+     * @param datagrams The datagrams to fill in order. Each buffer is sized to the bytes received.
+     * @return The number of datagrams actually received, which is at least one.
+     * @throws socket_error If the native recvmmsg call fails or the pool has no buffer left.
+     */
+    std::size_t receive_batch(buffer_pool& pool, gsl::span<pooled_datagram<TIP>> datagrams);
+
+    result<std::size_t>
+    receive_batch(std::nothrow_t, buffer_pool& pool, gsl::span<pooled_datagram<TIP>> datagrams) noexcept;
+
+    /**
+     * Let the kernel split every datagram sent by this socket into segments of the given size (UDP GSO).
+     * Only available on Linux.
+     * @param segment_size The size of each segment. Zero disables segmentation.
+     * @throws socket_error If the native setsockopt call fails or segmentation is not supported.
+     */
+    void set_segment_size(std::uint16_t segment_size);
+
+    /**
+     * @return The size of the segments datagrams are split into, or zero if segmentation is disabled.
+     * @throws socket_error If the native getsockopt call fails or segmentation is not supported.
+     */
+    [[nodiscard]] std::uint16_t get_segment_size() const;
+
+    /**
+     * Allow the kernel to coalesce consecutive datagrams from the same sender into one (UDP GRO).
+     * Such datagrams must be received with receive_coalesced. Only available on Linux.
+     * @param enable Whether datagrams may be coalesced.
+     * @throws socket_error If the native setsockopt call fails or coalescing is not supported.
+     */
+    void set_receive_offload(bool enable = true);
+
+    /**
+     * @return true, if datagrams may currently be coalesced, false otherwise.
+     * @throws socket_error If the native getsockopt call fails or coalescing is not supported.
+     */
+    [[nodiscard]] bool get_receive_offload() const;
+
+    /**
+     * Send one large buffer that the kernel splits into datagrams of segment_size bytes each.
+     * Only available on Linux.
+     * @param address The target address consisting of an IP address and a port number.
+     * @param data The bytes to send. Only the last segment may be shorter than segment_size.
+     * @param segment_size The size of each datagram.
+     * @return The number of bytes actually transmitted.
+     * @throws socket_error If the native sendmsg call fails or segmentation is not supported.
+     */
+    std::size_t send_segmented(address_t<TIP> const& address, const_buffer data, std::uint16_t segment_size);
+
+    result<std::size_t> send_segmented(
+        std::nothrow_t,
+        address_t<TIP> const& address,
+        const_buffer data,
+        std::uint16_t segment_size
+    ) noexcept;
+
+    /**
+     * Receive a datagram that might consist of several coalesced ones, see set_receive_offload.
+     * The buffer should be able to hold 64 KiB, as that is how large coalesced datagrams may grow.
+     * @param address The sender address. Can be nullptr if irrelevant.
+     * @param buffer The buffer receiving the incoming data.
+     * @return The total length and the size of the individual datagrams.
+     * @throws socket_error If the native recvmsg call fails.
+     */
+    coalesced_datagram receive_coalesced(address_t<TIP>* address, mutable_buffer buffer);
+
+    result<coalesced_datagram>
+    receive_coalesced(std::nothrow_t, address_t<TIP>* address, mutable_buffer buffer) noexcept;
+
+    /**
+     * Receive a datagram along with kernel timestamps, see set_timestamping.
+     * On platforms without timestamping this is a plain receive reporting no timestamps.
+     * @param address The sender address. Can be nullptr if irrelevant.
+     * @param buffer The buffer receiving the incoming data.
+     * @return The length of the datagram and when it arrived.
+     * @throws socket_error If the native recvmsg call fails.
+     */
+    timestamped_receive receive_timestamped(address_t<TIP>* const address, mutable_buffer const buffer)
+    {
+      return receive_timestamped_(address, buffer.data(), buffer.size()).value();
+    }
+
+    result<timestamped_receive>
+    receive_timestamped(std::nothrow_t, address_t<TIP>* const address, mutable_buffer const buffer) noexcept
+    {
+      return receive_timestamped_(address, buffer.data(), buffer.size());
+    }
+
   private:
-    std::size_t send_to_(address_t<TIP> const& address, std::byte const* data, std::size_t data_length);
+    result<std::size_t>
+    send_to_(address_t<TIP> const& address, std::byte const* data, std::size_t data_length) noexcept;
+
+    result<std::size_t>
+    receive_from_(address_t<TIP>* address, std::byte* buffer, std::size_t buffer_length) noexcept;
+  };
+
+  /**
+   * A UDP socket with a fixed peer, created by connecting a UDP socket.
+   * Avoids converting the address for every datagram and lets the kernel reuse the route to the peer.
+   */
+  template<ip_version_t TIP>
+  class connected_udp_socket final : public detail::socket_base<TIP, protocol_t::UDP> {
+    using base_t = detail::socket_base<TIP, protocol_t::UDP>;
+    using traits = native::socket_traits;
+    using base_t::send_;
+    using base_t::receive_;
+
+    friend class socket<TIP, protocol_t::UDP>;
+
+  public:
+    using base_t::close;
+    using base_t::is_valid;
+
+    /**
+     * Send a datagram to the peer.
+     * @tparam TData The type of data to send.
+     * @param data The data to send.
+     * @return The number of bytes actually transmitted.
+     * @throws socket_error If the native send call fails.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    std::size_t send(TData const& data)
+    {
+      return send_(reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData)).value();
+    }
+
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    result<std::size_t> send(std::nothrow_t, TData const& data) noexcept
+    {
+      return send_(reinterpret_cast<std::byte const*>(std::addressof(data)), sizeof(TData));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t send(gsl::span<TData, TExtent> const data)
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    result<std::size_t> send(std::nothrow_t, gsl::span<TData, TExtent> const data) noexcept
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    std::size_t send(std::span<TData, TExtent> const data)
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    result<std::size_t> send(std::nothrow_t, std::span<TData, TExtent> const data) noexcept
+    {
+      return send_(reinterpret_cast<std::byte const*>(data.data()), data.size_bytes());
+    }
+
+    /**
+     * Receive a datagram from the peer.
+     * @tparam TData The type of data to receive.
+     * @param buffer The buffer receiving the incoming data.
+     * @return The number of bytes actually received.
+     * @throws socket_error If the native recv call fails, e.g. because the peer is unreachable.
+     */
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    std::size_t receive(TData& buffer)
+    {
+      return receive_(reinterpret_cast<std::byte*>(std::addressof(buffer)), sizeof(TData)).value();
+    }
 
-    std::size_t receive_from_(address_t<TIP>* address, std::byte* buffer, std::size_t buffer_length);
+    template<concepts::Data TData>
+    requires (!concepts::View<TData>)
+    result<std::size_t> receive(std::nothrow_t, TData& buffer) noexcept
+    {
+      return receive_(reinterpret_cast<std::byte*>(std::addressof(buffer)), sizeof(TData));
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive(gsl::span<TData, TExtent> const buffer)
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    result<std::size_t> receive(std::nothrow_t, gsl::span<TData, TExtent> const buffer) noexcept
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    std::size_t receive(std::span<TData, TExtent> const buffer)
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes()).value();
+    }
+
+    template<concepts::Data TData, std::size_t TExtent>
+    requires (!std::is_const_v<TData>)
+    result<std::size_t> receive(std::nothrow_t, std::span<TData, TExtent> const buffer) noexcept
+    {
+      return receive_(reinterpret_cast<std::byte*>(buffer.data()), buffer.size_bytes());
+    }
+
+  private:
+    explicit connected_udp_socket(socket<TIP, protocol_t::UDP>&& sock) noexcept
+        :base_t{std::move(sock)}
+    {
+    }
   };
 
   extern template
@@ -238,8 +1135,16 @@ namespace tss {
   extern template
   class socket<ip_version_t::V6, protocol_t::UDP>;
 
+  extern template
+  class connected_udp_socket<ip_version_t::V4>;
+
+  extern template
+  class connected_udp_socket<ip_version_t::V6>;
+
   using tcp_socket_4 = socket<ip_version_t::V4, protocol_t::TCP>;
   using tcp_socket_6 = socket<ip_version_t::V6, protocol_t::TCP>;
   using udp_socket_4 = socket<ip_version_t::V4, protocol_t::UDP>;
   using udp_socket_6 = socket<ip_version_t::V6, protocol_t::UDP>;
+  using connected_udp_socket_4 = connected_udp_socket<ip_version_t::V4>;
+  using connected_udp_socket_6 = connected_udp_socket<ip_version_t::V6>;
 }
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "enums.hxx"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace tss {
+  /**
+   * Whether the library was built with TSS_WITH_STATS. Otherwise all statistics stay zero.
+   */
+#if defined(TSS_WITH_STATS)
+  bool constexpr stats_enabled = true;
+#else
+  bool constexpr stats_enabled = false;
+#endif
+
+  /**
+   * The number of buckets of a latency histogram.
+   */
+  std::size_t constexpr latency_buckets = 64U;
+
+  /**
+   * Call latencies bucketed by powers of two: bucket 0 counts calls below 1 ns, bucket i counts calls taking
+   * at least 2^(i-1) and less than 2^i nanoseconds.
+   */
+  struct latency_histogram final {
+    std::array<std::uint64_t, latency_buckets> buckets{};
+
+    /**
+     * @return The total number of recorded calls.
+     */
+    [[nodiscard]] std::uint64_t count() const noexcept;
+
+    /**
+     * Estimate a percentile by the upper bound of the bucket it falls into.
+     * @param fraction The percentile as a fraction between 0 and 1, e.g. 0.99.
+     * @return An upper bound of the latency below which the given fraction of calls stayed, zero if nothing was recorded.
+     */
+    [[nodiscard]] std::chrono::nanoseconds percentile(double fraction) const noexcept;
+  };
+
+  /**
+   * Counters of one kind of call.
+   */
+  struct operation_stats final {
+    /**
+     * The number of native calls.
+     */
+    std::uint64_t calls{0U};
+
+    /**
+     * The number of bytes transferred by successful calls.
+     */
+    std::uint64_t bytes{0U};
+
+    /**
+     * The number of calls that failed because they would have blocked.
+     */
+    std::uint64_t would_block{0U};
+
+    /**
+     * The number of calls that failed for any other reason.
+     */
+    std::uint64_t errors{0U};
+
+    /**
+     * The number of sends that transferred only part of the data.
+     */
+    std::uint64_t partial{0U};
+
+    latency_histogram latency{};
+  };
+
+  /**
+   * A snapshot of the statistics of a socket or of the whole process.
+   */
+  struct io_stats final {
+    std::array<operation_stats, 5U> operations{};
+
+    operation_stats const& operator[](io_operation_t const operation) const noexcept
+    {
+      return operations[static_cast<std::size_t>(operation)];
+    }
+  };
+
+  /**
+   * @return The statistics of all sockets of the process, including closed ones.
+   */
+  io_stats global_stats() noexcept;
+
+  namespace detail {
+    /**
+     * Lock-free counters updated by any number of threads.
+     */
+    class io_counters final {
+    public:
+      void record(
+          io_operation_t operation,
+          std::chrono::nanoseconds latency,
+          std::size_t requested,
+          std::ptrdiff_t result,
+          bool would_block
+      ) noexcept;
+
+      [[nodiscard]] io_stats snapshot() const noexcept;
+
+    private:
+      struct operation_counters final {
+        std::atomic<std::uint64_t> calls{0U};
+        std::atomic<std::uint64_t> bytes{0U};
+        std::atomic<std::uint64_t> would_block{0U};
+        std::atomic<std::uint64_t> errors{0U};
+        std::atomic<std::uint64_t> partial{0U};
+        std::array<std::atomic<std::uint64_t>, latency_buckets> latency{};
+      };
+
+      std::array<operation_counters, 5U> operations_{};
+    };
+
+    io_counters& global_counters() noexcept;
+
+    /**
+     * The stats policy of builds without TSS_WITH_STATS, which compiles down to nothing.
+     */
+    struct no_stats final {
+      struct counters final {
+      };
+
+      struct time_point final {
+      };
+
+      static time_point start() noexcept
+      {
+        return {};
+      }
+
+      static void record(counters&, io_operation_t, time_point, std::size_t, std::ptrdiff_t) noexcept
+      {
+      }
+
+      static io_stats snapshot(counters const&) noexcept
+      {
+        return {};
+      }
+    };
+
+    /**
+     * The stats policy of builds with TSS_WITH_STATS, counting per socket and for the whole process.
+     */
+    struct counting_stats final {
+      using time_point = std::chrono::steady_clock::time_point;
+
+      /**
+       * Allocated separately, so sockets stay movable and counters stay put while other threads update them.
+       * Sockets are also created by noexcept calls like accept, so a failed allocation leaves values empty and the
+       * socket only counts towards the global statistics.
+       */
+      struct counters final {
+        std::unique_ptr<io_counters> values{new(std::nothrow) io_counters{}};
+      };
+
+      static time_point start() noexcept
+      {
+        return std::chrono::steady_clock::now();
+      }
+
+      /**
+       * @param result What the native call returned: a byte count or -1 if it failed.
+       */
+      static void record(
+          counters& target,
+          io_operation_t operation,
+          time_point started,
+          std::size_t requested,
+          std::ptrdiff_t result
+      ) noexcept;
+
+      static io_stats snapshot(counters const& source) noexcept;
+    };
+
+#if defined(TSS_WITH_STATS)
+    using stats_policy = counting_stats;
+#else
+    using stats_policy = no_stats;
+#endif
+  }
+}
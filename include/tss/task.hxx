@@ -0,0 +1,185 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace tss {
+  template<typename T = void>
+  class task;
+
+  namespace detail {
+    template<typename T>
+    class task_promise_base {
+    public:
+      struct final_awaiter final {
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+          return false;
+        }
+
+        template<typename TPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TPromise> const coroutine) noexcept
+        {
+          if (auto const continuation = coroutine.promise().continuation_; continuation) {
+            return continuation;
+          }
+          return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+      };
+
+      std::suspend_always initial_suspend() const noexcept
+      {
+        return {};
+      }
+
+      final_awaiter final_suspend() const noexcept
+      {
+        return {};
+      }
+
+      void unhandled_exception() noexcept
+      {
+        result_.template emplace<std::exception_ptr>(std::current_exception());
+      }
+
+      void set_continuation(std::coroutine_handle<> const continuation) noexcept
+      {
+        continuation_ = continuation;
+      }
+
+    protected:
+      using value_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+      std::variant<std::monostate, value_t, std::exception_ptr> result_{};
+
+      value_t take_result()
+      {
+        if (auto const* const error = std::get_if<std::exception_ptr>(&result_); error!=nullptr) {
+          std::rethrow_exception(*error);
+        }
+        return std::move(std::get<1U>(result_));
+      }
+
+    private:
+      std::coroutine_handle<> continuation_{};
+    };
+
+    template<typename T>
+    class task_promise final : public task_promise_base<T> {
+    public:
+      task<T> get_return_object() noexcept;
+
+      template<typename TValue>
+      void return_value(TValue&& value)
+      {
+        this->result_.template emplace<1U>(std::forward<TValue>(value));
+      }
+
+      T result()
+      {
+        return this->take_result();
+      }
+    };
+
+    template<>
+    class task_promise<void> final : public task_promise_base<void> {
+    public:
+      task<void> get_return_object() noexcept;
+
+      void return_void() noexcept
+      {
+        result_.emplace<1U>();
+      }
+
+      void result()
+      {
+        take_result();
+      }
+    };
+  }
+
+  /**
+   * A lazily started coroutine producing a value of type T.
+   *
+   * The coroutine starts running when the task is awaited and resumes the awaiting coroutine when it finishes.
+   * Exceptions escaping the coroutine are rethrown to the awaiting coroutine.
+   */
+  template<typename T>
+  class [[nodiscard]] task final {
+  public:
+    using promise_type = detail::task_promise<T>;
+
+    task(task&& src) noexcept
+        :coroutine_{std::exchange(src.coroutine_, {})}
+    {
+    }
+
+    task(task const&) = delete;
+
+    task& operator=(task&&) = delete;
+
+    task& operator=(task const&) = delete;
+
+    ~task() noexcept
+    {
+      if (coroutine_) {
+        coroutine_.destroy();
+      }
+    }
+
+    auto operator co_await() && noexcept
+    {
+      struct awaiter final {
+        std::coroutine_handle<promise_type> coroutine;
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+          return coroutine.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> const continuation) const noexcept
+        {
+          coroutine.promise().set_continuation(continuation);
+          return coroutine;
+        }
+
+        T await_resume() const
+        {
+          return coroutine.promise().result();
+        }
+      };
+
+      return awaiter{coroutine_};
+    }
+
+  private:
+    friend promise_type;
+
+    explicit task(std::coroutine_handle<promise_type> const coroutine) noexcept
+        :coroutine_{coroutine}
+    {
+    }
+
+    std::coroutine_handle<promise_type> coroutine_;
+  };
+
+  namespace detail {
+    template<typename T>
+    task<T> task_promise<T>::get_return_object() noexcept
+    {
+      return task<T>{std::coroutine_handle<task_promise>::from_promise(*this)};
+    }
+
+    inline task<void> task_promise<void>::get_return_object() noexcept
+    {
+      return task<void>{std::coroutine_handle<task_promise>::from_promise(*this)};
+    }
+  }
+}
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "address.hxx"
+#include "enums.hxx"
+#include "native.hxx"
+#include "socket.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <gsl/assert>
+#include <gsl/span>
+
+namespace tss {
+  namespace detail {
+    struct uring_data;
+  }
+
+  /**
+   * Slot of a socket in the engine's table of registered descriptors.
+   * Operations on registered sockets skip the per-operation descriptor lookup in the kernel.
+   */
+  template<ip_version_t TIP, protocol_t TProto>
+  struct registered_socket final {
+    std::uint32_t index;
+  };
+
+  /**
+   * Completion based I/O engine using io_uring.
+   *
+   * Operations are queued with the prepare style member functions and handed to the kernel in batches,
+   * so a single system call can submit and reap many operations.
+   * Every operation carries an arbitrary user data value which is reported back with its completion.
+   * Buffers and sockets passed to an operation must stay alive until its completion has been reaped.
+   * Currently only available on Linux 6.0 or newer.
+   */
+  class uring_engine final {
+    using traits = native::socket_traits;
+
+  public:
+    /**
+     * The result of a finished operation.
+     */
+    struct completion final {
+      std::uint64_t user_data;
+      /**
+       * The number of transferred bytes, the handle of an accepted socket, or the negated error code.
+       */
+      std::int32_t result;
+      std::uint32_t flags;
+
+      [[nodiscard]] bool is_error() const noexcept
+      {
+        return result<0;
+      }
+
+      [[nodiscard]] int error_code() const noexcept
+      {
+        return is_error() ? -result : 0;
+      }
+
+      /**
+       * @return true, if the multishot operation that produced this completion stays armed.
+       */
+      [[nodiscard]] bool has_more() const noexcept;
+
+      /**
+       * @return The id of the provided buffer holding the received data, if the operation selected one.
+       */
+      [[nodiscard]] std::optional<std::uint16_t> buffer_id() const noexcept;
+    };
+
+    /**
+     * Creates a new ring.
+     * @param entries The number of submission queue entries. The completion queue is twice as large.
+     * @param registered_sockets The number of slots available for registered sockets.
+     * @throws socket_error If the ring could not be created.
+     */
+    explicit uring_engine(std::uint32_t entries = 256U, std::uint32_t registered_sockets = 0U,
+        native::socket_api const& = native::socket_api::instance());
+
+    uring_engine(uring_engine const&) = delete;
+
+    uring_engine& operator=(uring_engine const&) = delete;
+
+    /**
+     * The destructor cancels all pending operations and waits for their completions before it tears down the ring,
+     * so their buffers may be released right after the engine. Operations queued but not yet submitted are submitted
+     * first and cancelled as well.
+     */
+    ~uring_engine() noexcept;
+
+    /**
+     * Register a socket in a free slot of the descriptor table.
+     * @throws socket_error If there is no free slot or the native register call fails.
+     */
+    template<ip_version_t TIP, protocol_t TProto>
+    registered_socket<TIP, TProto> register_socket(socket<TIP, TProto> const& sock)
+    {
+      return {register_(sock.native_handle())};
+    }
+
+    /**
+     * Release a slot of the descriptor table. The socket itself stays open.
+     * @throws socket_error If the native register call fails.
+     */
+    template<ip_version_t TIP, protocol_t TProto>
+    void unregister_socket(registered_socket<TIP, TProto> const sock)
+    {
+      unregister_(sock.index);
+    }
+
+    /**
+     * Queue sending data to the connected peer. At most 4 GiB - 1 bytes are sent, the completion reports how many.
+     */
+    template<ip_version_t TIP, protocol_t TProto>
+    void send(socket<TIP, TProto> const& sock, gsl::span<std::byte const> data, std::uint64_t user_data)
+    {
+      send_({sock.native_handle(), false}, data, user_data);
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    void send(registered_socket<TIP, TProto> const sock, gsl::span<std::byte const> data, std::uint64_t user_data)
+    {
+      send_({static_cast<int>(sock.index), true}, data, user_data);
+    }
+
+    /**
+     * Queue sending a datagram to the given address.
+     */
+    template<ip_version_t TIP>
+    void send_to(socket<TIP, protocol_t::UDP> const& sock, address_t<TIP> const& address,
+        gsl::span<std::byte const> data, std::uint64_t user_data)
+    {
+      send_to_({sock.native_handle(), false}, address, data, user_data);
+    }
+
+    template<ip_version_t TIP>
+    void send_to(registered_socket<TIP, protocol_t::UDP> const sock, address_t<TIP> const& address,
+        gsl::span<std::byte const> data, std::uint64_t user_data)
+    {
+      send_to_({static_cast<int>(sock.index), true}, address, data, user_data);
+    }
+
+    /**
+     * Queue receiving data into the given buffer, of which at most 4 GiB - 1 bytes are used.
+     */
+    template<ip_version_t TIP, protocol_t TProto>
+    void receive(socket<TIP, TProto> const& sock, gsl::span<std::byte> buffer, std::uint64_t user_data)
+    {
+      receive_({sock.native_handle(), false}, buffer, user_data);
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    void receive(registered_socket<TIP, TProto> const sock, gsl::span<std::byte> buffer, std::uint64_t user_data)
+    {
+      receive_({static_cast<int>(sock.index), true}, buffer, user_data);
+    }
+
+    /**
+     * Queue a receive that completes once per incoming chunk of data until it fails or runs out of buffers.
+     * Each completion uses one buffer of the given group, which is reported by completion::buffer_id.
+     */
+    template<ip_version_t TIP, protocol_t TProto>
+    void receive_multishot(socket<TIP, TProto> const& sock, std::uint16_t buffer_group, std::uint64_t user_data)
+    {
+      receive_multishot_({sock.native_handle(), false}, buffer_group, user_data);
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    void receive_multishot(registered_socket<TIP, TProto> const sock, std::uint16_t buffer_group,
+        std::uint64_t user_data)
+    {
+      receive_multishot_({static_cast<int>(sock.index), true}, buffer_group, user_data);
+    }
+
+    /**
+     * Queue accepting a connection. The completion result is the handle of the new socket, see accepted.
+     * @param multishot Whether to keep accepting connections, producing one completion per connection.
+     */
+    template<ip_version_t TIP>
+    void accept(socket<TIP, protocol_t::TCP> const& sock, std::uint64_t user_data, bool multishot = false)
+    {
+      accept_({sock.native_handle(), false}, user_data, multishot);
+    }
+
+    template<ip_version_t TIP>
+    void accept(registered_socket<TIP, protocol_t::TCP> const sock, std::uint64_t user_data, bool multishot = false)
+    {
+      accept_({static_cast<int>(sock.index), true}, user_data, multishot);
+    }
+
+    /**
+     * Take ownership of the socket produced by a successful accept completion.
+     * @param accept_completion The completion of an accept, which must not be an error.
+     */
+    template<ip_version_t TIP>
+    [[nodiscard]] static socket<TIP, protocol_t::TCP> accepted(completion const& accept_completion) noexcept
+    {
+      Expects(!accept_completion.is_error());
+      return socket<TIP, protocol_t::TCP>{static_cast<traits::socket_t>(accept_completion.result)};
+    }
+
+    /**
+     * Queue establishing a connection to a server.
+     */
+    template<ip_version_t TIP>
+    void connect(socket<TIP, protocol_t::TCP> const& sock, address_t<TIP> const& address, std::uint64_t user_data)
+    {
+      connect_({sock.native_handle(), false}, address, user_data);
+    }
+
+    template<ip_version_t TIP>
+    void connect(registered_socket<TIP, protocol_t::TCP> const sock, address_t<TIP> const& address,
+        std::uint64_t user_data)
+    {
+      connect_({static_cast<int>(sock.index), true}, address, user_data);
+    }
+
+    /**
+     * Queue handing buffers to the kernel for operations selecting their buffer on their own.
+     * @param buffer_group The group the buffers are added to.
+     * @param storage Memory split into consecutive buffers, whose ids count up from first_id.
+     * @param buffer_size The size of every single buffer, at most 4 GiB - 1 bytes. Larger sizes are clamped, which also
+     * moves the buffers to multiples of the clamped size.
+     */
+    void provide_buffers(std::uint16_t buffer_group, gsl::span<std::byte> storage, std::size_t buffer_size,
+        std::uint16_t first_id, std::uint64_t user_data);
+
+    /**
+     * Submit all queued operations without waiting.
+     * @return The number of submitted operations.
+     * @throws socket_error If the native enter call fails.
+     */
+    std::size_t submit();
+
+    /**
+     * Submit all queued operations and wait until at least the given number of completions is available.
+     * @return The available completions. The span stays valid until the next call to wait or poll.
+     * @throws socket_error If the native enter call fails.
+     */
+    gsl::span<completion const> wait(std::size_t min_completions = 1U);
+
+    /**
+     * Submit all queued operations and collect the completions that are already available.
+     * @return The available completions. The span stays valid until the next call to wait or poll.
+     * @throws socket_error If the native enter call fails.
+     */
+    gsl::span<completion const> poll();
+
+  private:
+    struct target final {
+      int fd;
+      bool fixed;
+    };
+
+    std::uint32_t register_(traits::socket_t sock);
+
+    void unregister_(std::uint32_t index);
+
+    void send_(target sock, gsl::span<std::byte const> data, std::uint64_t user_data);
+
+    void send_to_(target sock, address_v4_t const& address, gsl::span<std::byte const> data,
+        std::uint64_t user_data);
+
+    void send_to_(target sock, address_v6_t const& address, gsl::span<std::byte const> data,
+        std::uint64_t user_data);
+
+    void receive_(target sock, gsl::span<std::byte> buffer, std::uint64_t user_data);
+
+    void receive_multishot_(target sock, std::uint16_t buffer_group, std::uint64_t user_data);
+
+    void accept_(target sock, std::uint64_t user_data, bool multishot);
+
+    void connect_(target sock, address_v4_t const& address, std::uint64_t user_data);
+
+    void connect_(target sock, address_v6_t const& address, std::uint64_t user_data);
+
+    std::unique_ptr<detail::uring_data> data_;
+  };
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "buffer.hxx"
+#include "enums.hxx"
+#include "native.hxx"
+#include "result.hxx"
+#include "socket.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace tss {
+  namespace detail {
+    struct zero_copy_data;
+  }
+
+  /**
+   * Identifies a zero-copy send, so its completion can be looked up.
+   */
+  struct zero_copy_handle final {
+    std::uint32_t id;
+
+    bool operator==(zero_copy_handle const&) const noexcept = default;
+  };
+
+  /**
+   * The outcome of a zero-copy send.
+   */
+  struct zero_copy_send final {
+    /**
+     * The number of bytes actually transmitted. They must stay untouched until the send completed.
+     */
+    std::size_t bytes;
+
+    /**
+     * Identifies the send when asking whether it completed. Sends that transmitted nothing are complete right away and
+     * get the handle of an earlier completed send, as the kernel does not number them.
+     */
+    zero_copy_handle handle;
+  };
+
+  /**
+   * Sends from a TCP socket without copying the payload into the kernel (MSG_ZEROCOPY).
+   *
+   * The kernel keeps referencing the sent bytes until it reports the send as completed, so buffers must not be reused
+   * or freed before is_complete returns true for the handle of their send. Completions are queued on the socket error
+   * queue, which makes the socket readable for the selector and reports an error event in the poller. Call reap
+   * afterwards to collect them. Zero-copy only pays off for large sends, on loopback the kernel copies anyway.
+   * Currently only available on Linux.
+   * @tparam TIP The IP version of the socket.
+   */
+  template<ip_version_t TIP>
+  class zero_copy_sender final {
+    using traits = native::socket_traits;
+
+  public:
+    /**
+     * Enable zero-copy sends on the socket, which must outlive the sender.
+     * @param sock The socket to send from.
+     * @throws socket_error If the native setsockopt call fails, e.g. because the kernel does not support SO_ZEROCOPY.
+     */
+    explicit zero_copy_sender(socket<TIP, protocol_t::TCP>& sock);
+
+    zero_copy_sender(zero_copy_sender&& src) noexcept;
+
+    zero_copy_sender(zero_copy_sender const&) = delete;
+
+    zero_copy_sender& operator=(zero_copy_sender&&) = delete;
+
+    zero_copy_sender& operator=(zero_copy_sender const&) = delete;
+
+    ~zero_copy_sender() noexcept;
+
+    /**
+     * Access the native handle of the socket, so the sender can be passed to the selector or the poller.
+     */
+    [[nodiscard]] traits::socket_t native_handle() const noexcept;
+
+    /**
+     * Send data to the connected peer without copying it.
+     * @param data The bytes to send.
+     * @return The number of bytes actually transmitted and the handle of the send.
+     * @throws socket_error If the native send call fails.
+     */
+    zero_copy_send send(const_buffer data);
+
+    result<zero_copy_send> send(std::nothrow_t, const_buffer data) noexcept;
+
+    /**
+     * Collect the completions queued on the socket without blocking.
+     * @return The number of sends that completed.
+     * @throws socket_error If the native recvmsg call fails.
+     */
+    std::size_t reap();
+
+    /**
+     * Check whether the kernel released the bytes of a send.
+     * @param handle The handle returned by send.
+     * @return true, if the bytes may be reused, false otherwise.
+     */
+    [[nodiscard]] bool is_complete(zero_copy_handle handle) const noexcept;
+
+    /**
+     * @return The number of sends that did not complete yet.
+     */
+    [[nodiscard]] std::size_t pending() const noexcept;
+
+    /**
+     * @return The number of completed sends for which the kernel fell back to copying the bytes.
+     */
+    [[nodiscard]] std::size_t copied() const noexcept;
+
+  private:
+    socket<TIP, protocol_t::TCP>* sock_;
+    std::unique_ptr<detail::zero_copy_data> data_;
+  };
+
+  extern template
+  class zero_copy_sender<ip_version_t::V4>;
+
+  extern template
+  class zero_copy_sender<ip_version_t::V6>;
+}
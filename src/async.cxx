@@ -0,0 +1,277 @@
+#include <tss/async.hxx>
+#include <tss/poller.hxx>
+
+#include <cerrno>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+
+#include <gsl/assert>
+
+namespace {
+  struct detached final {
+    struct promise_type final {
+      detached get_return_object() const noexcept
+      {
+        return {};
+      }
+
+      std::suspend_never initial_suspend() const noexcept
+      {
+        return {};
+      }
+
+      std::suspend_never final_suspend() const noexcept
+      {
+        return {};
+      }
+
+      void return_void() const noexcept
+      {
+      }
+
+      void unhandled_exception() const noexcept
+      {
+        std::terminate();
+      }
+    };
+  };
+
+  /**
+   * Lets a bare descriptor satisfy the Socket concept, so it can be handed to the poller.
+   */
+  struct descriptor final {
+    int fd;
+
+    [[nodiscard]] int native_handle() const noexcept
+    {
+      return fd;
+    }
+  };
+
+  void set_non_blocking(int const sock)
+  {
+    auto const flags = ::fcntl(sock, F_GETFL);
+    if (flags==-1 || ::fcntl(sock, F_SETFL, flags | O_NONBLOCK)==-1) {
+      throw tss::socket_error{};
+    }
+  }
+}
+
+namespace tss {
+  namespace detail {
+    struct reactor_slot final {
+      std::coroutine_handle<> reader{};
+      std::coroutine_handle<> writer{};
+      poll_event_t interest{poll_event_t::None};
+      bool registered{false};
+      bool non_blocking{false};
+    };
+
+    struct reactor_data final {
+      tss::poller poller{};
+      // indexed by descriptor, just like the poller does internally
+      std::vector<reactor_slot> slots{};
+      std::size_t active{0U};
+      bool stopped{false};
+      std::exception_ptr error{};
+
+      reactor_slot& slot(int const sock)
+      {
+        auto const index = static_cast<std::size_t>(sock);
+        if (index>=slots.size()) {
+          slots.resize(index+1U);
+        }
+        return slots[index];
+      }
+
+      void prepare(int const sock)
+      {
+        if (auto& current = slot(sock); !current.non_blocking) {
+          ::set_non_blocking(sock);
+          current.non_blocking = true;
+        }
+      }
+
+      void update(int const sock)
+      {
+        auto& current = slot(sock);
+        auto desired{poll_event_t::None};
+        if (current.reader) {
+          desired = desired | poll_event_t::Read;
+        }
+        if (current.writer) {
+          desired = desired | poll_event_t::Write;
+        }
+
+        if (current.registered && desired==current.interest) {
+          return;
+        }
+
+        // errors and hang ups are reported even without interest, so idle sockets must not stay level triggered
+        auto const trigger = desired==poll_event_t::None ? trigger_t::OneShot : trigger_t::Level;
+        ::descriptor const target{sock};
+
+        if (current.registered) {
+          try {
+            poller.modify(target, desired, nullptr, trigger);
+          }
+          catch (socket_error const& ex) {
+            // the descriptor was closed and reused without releasing it first
+            if (ex.error_code()!=ENOENT) {
+              throw;
+            }
+            poller.add(target, desired, nullptr, trigger);
+          }
+        }
+        else {
+          prepare(sock);
+          poller.add(target, desired, nullptr, trigger);
+          current.registered = true;
+        }
+        current.interest = desired;
+      }
+
+      detached run(task<void> coroutine)
+      {
+        try {
+          co_await std::move(coroutine);
+        }
+        catch (...) {
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+        --active;
+      }
+    };
+  }
+
+  reactor::reactor(native::socket_api const&)
+      :data_{std::make_unique<detail::reactor_data>()}
+  {
+  }
+
+  reactor::~reactor() noexcept
+  = default;
+
+  void reactor::spawn(task<void> coroutine)
+  {
+    ++data_->active;
+    data_->run(std::move(coroutine));
+  }
+
+  void reactor::run()
+  {
+    data_->stopped = false;
+    while (data_->active>0U && !data_->stopped) {
+      if (data_->error) {
+        break;
+      }
+      run_once();
+    }
+    if (data_->error) {
+      std::rethrow_exception(std::exchange(data_->error, {}));
+    }
+  }
+
+  std::size_t reactor::run_once(std::chrono::milliseconds const time_out)
+  {
+    std::size_t resumed{0U};
+    for (auto const& event: data_->poller.wait(time_out)) {
+      auto const failed = event.is_error() || event.is_hang_up();
+
+      // resuming may grow the slots, so never hold on to a reference across a resumption
+      if (auto const reader = data_->slot(event.socket).reader; reader && (event.is_read() || failed)) {
+        data_->slot(event.socket).reader = {};
+        reader.resume();
+        ++resumed;
+      }
+      if (auto const writer = data_->slot(event.socket).writer; writer && (event.is_write() || failed)) {
+        data_->slot(event.socket).writer = {};
+        writer.resume();
+        ++resumed;
+      }
+
+      if (data_->slot(event.socket).registered) {
+        data_->update(event.socket);
+      }
+    }
+    return resumed;
+  }
+
+  void reactor::stop() noexcept
+  {
+    data_->stopped = true;
+  }
+
+  void reactor::wait_(traits::socket_t const sock, poll_event_t const event, std::coroutine_handle<> const coroutine)
+  {
+    auto& current = data_->slot(sock);
+    if (event==poll_event_t::Read) {
+      Expects(!current.reader);
+      current.reader = coroutine;
+    }
+    else {
+      Expects(!current.writer);
+      current.writer = coroutine;
+    }
+
+    try {
+      data_->update(sock);
+    }
+    catch (...) {
+      auto& failed = data_->slot(sock);
+      (event==poll_event_t::Read ? failed.reader : failed.writer) = {};
+      throw;
+    }
+  }
+
+  void reactor::prepare_(traits::socket_t const sock)
+  {
+    data_->prepare(sock);
+  }
+
+  void reactor::release_(traits::socket_t const sock)
+  {
+    auto& current = data_->slot(sock);
+    Expects(!current.reader && !current.writer);
+    if (current.registered) {
+      ::descriptor const target{sock};
+      try {
+        data_->poller.remove(target);
+      }
+      catch (socket_error const& ex) {
+        (void) ex;
+      }
+    }
+    current = {};
+  }
+
+  template<ip_version_t TIP>
+  task<void> async_connect(reactor& loop, socket<TIP, protocol_t::TCP>& sock, address_t<TIP> const& address)
+  {
+    loop.prepare(sock);
+    if (auto const result = sock.connect(std::nothrow, address); result || !result.error().in_progress()) {
+      co_return result.value();
+    }
+
+    co_await loop.writable(sock);
+
+    int error{};
+    auto len{static_cast<socklen_t>(sizeof(error))};
+    if (::getsockopt(sock.native_handle(), SOL_SOCKET, SO_ERROR, &error, &len)==-1) {
+      throw socket_error{};
+    }
+    if (error!=0) {
+      throw socket_error{error};
+    }
+  }
+
+  template
+  task<void> async_connect(reactor&, socket<ip_version_t::V4, protocol_t::TCP>&, address_v4_t const&);
+
+  template
+  task<void> async_connect(reactor&, socket<ip_version_t::V6, protocol_t::TCP>&, address_v6_t const&);
+}
@@ -0,0 +1,375 @@
+#include <tss/buffer_pool.hxx>
+#include <tss/exceptions.hxx>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
+#include <gsl/assert>
+
+namespace {
+  std::uint32_t constexpr empty_index{std::numeric_limits<std::uint32_t>::max()};
+
+  // the head of the free stack carries a tag that changes with every update, so a stale head never compares equal
+  std::uint64_t pack(std::uint32_t const index, std::uint64_t const tag) noexcept
+  {
+    return (tag << 32U) | index;
+  }
+
+  std::uint32_t index_of(std::uint64_t const head) noexcept
+  {
+    return static_cast<std::uint32_t>(head & 0xFFFFFFFFU);
+  }
+
+  std::uint64_t tag_of(std::uint64_t const head) noexcept
+  {
+    return head >> 32U;
+  }
+
+  std::uint64_t next_pool_id() noexcept
+  {
+    static std::atomic<std::uint64_t> id{0U};
+    return id.fetch_add(1U, std::memory_order_relaxed)+1U;
+  }
+
+  /**
+   * The pools alive, so caches of exiting threads only return buffers to pools that still exist.
+   */
+  struct pool_registry final {
+    std::mutex mutex{};
+    std::unordered_set<std::uint64_t> pools{};
+  };
+
+  pool_registry& registry()
+  {
+    static pool_registry instance{};
+    return instance;
+  }
+}
+
+namespace tss {
+  namespace detail {
+    struct thread_buffer_cache final {
+      std::uint64_t pool_id;
+      buffer_pool* pool;
+      std::vector<std::uint32_t> indices;
+
+      /**
+       * @return The cache of the calling thread for the pool, created on first use.
+       * @throws std::bad_alloc If a new cache could not be allocated.
+       */
+      static thread_buffer_cache& of(buffer_pool& pool);
+
+      /**
+       * Forget the cache of the calling thread for a pool that is going away.
+       */
+      static void drop(std::uint64_t pool_id) noexcept;
+
+      /**
+       * Return cached buffers to the pool, provided it is still alive.
+       */
+      void flush() noexcept
+      {
+        std::lock_guard const lock{::registry().mutex};
+        if (!indices.empty() && ::registry().pools.contains(pool_id)) {
+          pool->push_(indices.data(), indices.size());
+        }
+        indices.clear();
+      }
+    };
+
+    namespace {
+      struct thread_buffer_caches final {
+        std::vector<thread_buffer_cache> entries{};
+
+        thread_buffer_caches() = default;
+
+        thread_buffer_caches(thread_buffer_caches const&) = delete;
+
+        thread_buffer_caches& operator=(thread_buffer_caches const&) = delete;
+
+        ~thread_buffer_caches() noexcept
+        {
+          for (auto& entry: entries) {
+            entry.flush();
+          }
+        }
+      };
+
+      thread_local thread_buffer_caches caches{};
+    }
+
+    thread_buffer_cache& thread_buffer_cache::of(buffer_pool& pool)
+    {
+      auto& entries = caches.entries;
+      // threads rarely use more than a pool or two, so a linear search is fastest
+      for (auto it = entries.rbegin(); it!=entries.rend(); ++it) {
+        if (it->pool_id==pool.id_) {
+          return *it;
+        }
+      }
+
+      {
+        // a new pool is a good time to clean up after pools that went away
+        std::lock_guard const lock{::registry().mutex};
+        std::erase_if(entries, [](thread_buffer_cache const& entry) {
+          return !::registry().pools.contains(entry.pool_id);
+        });
+      }
+
+      thread_buffer_cache cache{pool.id_, &pool, {}};
+      cache.indices.reserve(pool.cache_size_+1U);
+      return entries.emplace_back(std::move(cache));
+    }
+
+    void thread_buffer_cache::drop(std::uint64_t const pool_id) noexcept
+    {
+      std::erase_if(caches.entries, [pool_id](thread_buffer_cache const& entry) {
+        return entry.pool_id==pool_id;
+      });
+    }
+  }
+
+  pooled_buffer::pooled_buffer(
+      buffer_pool& pool,
+      std::uint32_t const index,
+      std::byte* const data,
+      std::size_t const capacity
+  ) noexcept
+      :pool_{&pool}, index_{index}, data_{data}, size_{capacity}, capacity_{capacity}
+  {
+  }
+
+  pooled_buffer::pooled_buffer(pooled_buffer&& other) noexcept
+      :pool_{std::exchange(other.pool_, nullptr)},
+       index_{other.index_},
+       data_{std::exchange(other.data_, nullptr)},
+       size_{std::exchange(other.size_, 0U)},
+       capacity_{std::exchange(other.capacity_, 0U)}
+  {
+  }
+
+  pooled_buffer& pooled_buffer::operator=(pooled_buffer&& other) noexcept
+  {
+    if (this!=&other) {
+      reset();
+      pool_ = std::exchange(other.pool_, nullptr);
+      index_ = other.index_;
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0U);
+      capacity_ = std::exchange(other.capacity_, 0U);
+    }
+    return *this;
+  }
+
+  pooled_buffer::~pooled_buffer() noexcept
+  {
+    reset();
+  }
+
+  void pooled_buffer::resize(std::size_t const size) noexcept
+  {
+    Expects(size<=capacity_);
+    size_ = size;
+  }
+
+  void pooled_buffer::reset() noexcept
+  {
+    if (pool_!=nullptr) {
+      std::exchange(pool_, nullptr)->release_(index_);
+      data_ = nullptr;
+      size_ = 0U;
+      capacity_ = 0U;
+    }
+  }
+
+  buffer_pool::buffer_pool(
+      std::size_t const buffer_size,
+      std::size_t const max_buffers,
+      std::size_t const slab_buffers,
+      std::size_t const cache_size
+  )
+      :id_{::next_pool_id()},
+       buffer_size_{buffer_size},
+       max_buffers_{max_buffers},
+       slab_buffers_{slab_buffers},
+       cache_size_{cache_size},
+       slabs_((max_buffers+slab_buffers-1U)/std::max(slab_buffers, std::size_t{1U})),
+       next_{std::make_unique<std::atomic<std::uint32_t>[]>(max_buffers)},
+       head_{::pack(::empty_index, 0U)}
+  {
+    Expects(buffer_size>0U && slab_buffers>0U && max_buffers<::empty_index);
+    std::lock_guard const lock{::registry().mutex};
+    ::registry().pools.insert(id_);
+  }
+
+  buffer_pool::~buffer_pool() noexcept
+  {
+    {
+      std::lock_guard const lock{::registry().mutex};
+      ::registry().pools.erase(id_);
+    }
+    detail::thread_buffer_cache::drop(id_);
+  }
+
+  pooled_buffer buffer_pool::acquire()
+  {
+    return acquire(std::nothrow).value();
+  }
+
+  result<pooled_buffer> buffer_pool::acquire(std::nothrow_t) noexcept
+  {
+    std::uint32_t index{::empty_index};
+    try {
+      auto& cache = detail::thread_buffer_cache::of(*this);
+      auto& indices = cache.indices;
+      while (indices.empty()) {
+        // refill only half of the cache, so the buffers released next do not spill right away
+        indices.resize(std::max(cache_size_/2U, std::size_t{1U}));
+        auto const taken = pop_(indices.data(), indices.size());
+        indices.resize(taken);
+        if (taken==0U && !grow_()) {
+          break;
+        }
+      }
+
+      if (!indices.empty()) {
+        index = indices.back();
+        indices.pop_back();
+      }
+    }
+    catch (std::bad_alloc const&) {
+      // without a cache, a single buffer is taken from the shared stack
+      if (pop_(&index, 1U)==0U && grow_()) {
+        (void) pop_(&index, 1U);
+      }
+    }
+
+    if (index==::empty_index) {
+      exhausted_.fetch_add(1U, std::memory_order_relaxed);
+      return error_code::no_buffer_space();
+    }
+
+    auto const in_use = in_use_.fetch_add(1U, std::memory_order_relaxed)+1U;
+    auto peak = peak_in_use_.load(std::memory_order_relaxed);
+    while (peak<in_use && !peak_in_use_.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)) {
+    }
+    return pooled_buffer{*this, index, data_(index), buffer_size_};
+  }
+
+  buffer_pool_stats buffer_pool::stats() const noexcept
+  {
+    return buffer_pool_stats{
+        buffer_size_,
+        allocated_.load(std::memory_order_relaxed),
+        max_buffers_,
+        in_use_.load(std::memory_order_relaxed),
+        peak_in_use_.load(std::memory_order_relaxed),
+        exhausted_.load(std::memory_order_relaxed)
+    };
+  }
+
+  void buffer_pool::release_(std::uint32_t index) noexcept
+  {
+    in_use_.fetch_sub(1U, std::memory_order_relaxed);
+    try {
+      auto& indices = detail::thread_buffer_cache::of(*this).indices;
+      indices.push_back(index);
+      if (indices.size()>cache_size_) {
+        // keep half of the cache, so alternating acquires and releases do not touch the stack every time
+        auto const keep = cache_size_/2U;
+        push_(indices.data()+keep, indices.size()-keep);
+        indices.resize(keep);
+      }
+    }
+    catch (std::bad_alloc const&) {
+      push_(&index, 1U);
+    }
+  }
+
+  std::byte* buffer_pool::data_(std::uint32_t const index) const noexcept
+  {
+    return slabs_[index/slab_buffers_].get()+(index%slab_buffers_)*buffer_size_;
+  }
+
+  bool buffer_pool::grow_() noexcept
+  {
+    std::lock_guard const lock{grow_mutex_};
+    auto const allocated = allocated_.load(std::memory_order_relaxed);
+    if (allocated>=max_buffers_) {
+      return false;
+    }
+
+    // another thread may have grown the pool meanwhile, which is fine, as the caller simply tries again
+    auto const count = std::min(slab_buffers_, max_buffers_-allocated);
+    auto& slab = slabs_[allocated/slab_buffers_];
+    slab.reset(new(std::nothrow) std::byte[count*buffer_size_]);
+    if (!slab) {
+      return false;
+    }
+
+    std::vector<std::uint32_t> indices{};
+    try {
+      indices.resize(count);
+    }
+    catch (std::bad_alloc const&) {
+      slab.reset();
+      return false;
+    }
+    for (std::size_t i = 0U; i<count; ++i) {
+      indices[i] = static_cast<std::uint32_t>(allocated+i);
+    }
+    allocated_.store(allocated+count, std::memory_order_relaxed);
+    push_(indices.data(), count);
+    return true;
+  }
+
+  std::size_t buffer_pool::pop_(std::uint32_t* const indices, std::size_t const count) noexcept
+  {
+    auto head = head_.load(std::memory_order_acquire);
+    for (;;) {
+      std::size_t taken{0U};
+      auto current = ::index_of(head);
+      // links read here may be stale if other threads raced us, but then the tag changed and the exchange fails
+      while (taken<count && current!=::empty_index) {
+        indices[taken++] = current;
+        current = next_[current].load(std::memory_order_relaxed);
+      }
+      if (taken==0U) {
+        return 0U;
+      }
+
+      if (head_.compare_exchange_weak(
+          head,
+          ::pack(current, ::tag_of(head)+1U),
+          std::memory_order_acquire,
+          std::memory_order_acquire
+      )) {
+        return taken;
+      }
+    }
+  }
+
+  void buffer_pool::push_(std::uint32_t const* const indices, std::size_t const count) noexcept
+  {
+    if (count==0U) {
+      return;
+    }
+
+    for (std::size_t i = 0U; i+1U<count; ++i) {
+      next_[indices[i]].store(indices[i+1U], std::memory_order_relaxed);
+    }
+
+    auto head = head_.load(std::memory_order_relaxed);
+    do {
+      next_[indices[count-1U]].store(::index_of(head), std::memory_order_relaxed);
+    }
+    while (!head_.compare_exchange_weak(
+        head,
+        ::pack(indices[0U], ::tag_of(head)+1U),
+        std::memory_order_release,
+        std::memory_order_relaxed
+    ));
+  }
+}
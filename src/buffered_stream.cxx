@@ -0,0 +1,124 @@
+#include <tss/buffered_stream.hxx>
+#include <tss/exceptions.hxx>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace tss {
+  template<ip_version_t TIP>
+  buffered_stream<TIP>::buffered_stream(
+      socket_t& sock,
+      std::size_t const write_capacity,
+      std::size_t const read_capacity,
+      flush_t const flush
+  )
+      :sock_{&sock}, write_capacity_{write_capacity}, flush_{flush}, read_buffer_(read_capacity)
+  {
+    write_buffer_.reserve(write_capacity);
+  }
+
+  template<ip_version_t TIP>
+  buffered_stream<TIP>::~buffered_stream() noexcept
+  {
+    (void) flush(std::nothrow);
+  }
+
+  template<ip_version_t TIP>
+  void buffered_stream<TIP>::flush()
+  {
+    flush(std::nothrow).value();
+  }
+
+  template<ip_version_t TIP>
+  result<void> buffered_stream<TIP>::flush(std::nothrow_t) noexcept
+  {
+    std::size_t offset{0U};
+    while (offset<write_buffer_.size()) {
+      auto const sent = sock_->send(std::nothrow, gsl::span<std::byte const>{write_buffer_}.subspan(offset));
+      if (!sent) {
+        if (sent.error()==error_code::interrupted()) {
+          continue;
+        }
+        write_buffer_.erase(write_buffer_.begin(), write_buffer_.begin()+static_cast<std::ptrdiff_t>(offset));
+        return sent.error();
+      }
+      offset += *sent;
+    }
+    write_buffer_.clear();
+    return {};
+  }
+
+  template<ip_version_t TIP>
+  void buffered_stream<TIP>::write_(const_buffer const data)
+  {
+    if (write_buffer_.size()+data.size()<=write_capacity_) {
+      write_buffer_.insert(write_buffer_.end(), data.begin(), data.end());
+      return;
+    }
+
+    if (data.size()<write_capacity_) {
+      flush();
+      write_buffer_.insert(write_buffer_.end(), data.begin(), data.end());
+      return;
+    }
+
+    // too large to be worth copying, so it goes out right behind the buffered data in the same call
+    std::array<const_buffer, 2U> buffers{const_buffer{write_buffer_}, data};
+    auto remaining = gsl::span<const_buffer>{buffers};
+    std::size_t sent_total{0U};
+    while (!remaining.empty()) {
+      auto const sent = sock_->send_vectored(std::nothrow, remaining);
+      if (!sent) {
+        if (sent.error()==error_code::interrupted()) {
+          continue;
+        }
+        // buffered bytes that went out must not be sent again by the next flush
+        auto const sent_buffered = std::min(sent_total, write_buffer_.size());
+        write_buffer_.erase(write_buffer_.begin(), write_buffer_.begin()+static_cast<std::ptrdiff_t>(sent_buffered));
+        throw socket_error{sent.error().value()};
+      }
+      sent_total += sent->bytes;
+      remaining = remaining_buffers(remaining, *sent);
+    }
+    write_buffer_.clear();
+  }
+
+  template<ip_version_t TIP>
+  std::size_t buffered_stream<TIP>::read_(mutable_buffer data)
+  {
+    std::size_t received{0U};
+    for (;;) {
+      auto const count = std::min(data.size(), read_end_-read_begin_);
+      std::memcpy(data.data(), read_buffer_.data()+read_begin_, count);
+      read_begin_ += count;
+      received += count;
+      data = data.subspan(count);
+      if (data.empty()) {
+        return received;
+      }
+
+      if (flush_==flush_t::BeforeReceive) {
+        flush();
+      }
+
+      // the read-ahead buffer is empty by now, so large receives can skip it
+      if (data.size()>=read_buffer_.size()) {
+        return received+sock_->receive_exact(data);
+      }
+
+      auto const refilled = sock_->receive(gsl::span<std::byte>{read_buffer_});
+      if (refilled==0U) {
+        return received;
+      }
+      read_begin_ = 0U;
+      read_end_ = refilled;
+    }
+  }
+
+  template
+  class buffered_stream<ip_version_t::V4>;
+
+  template
+  class buffered_stream<ip_version_t::V6>;
+}
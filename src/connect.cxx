@@ -0,0 +1,206 @@
+#include <tss/connect.hxx>
+#include <tss/exceptions.hxx>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+#include <Windows.h>
+#include <WinSock2.h>
+
+#else
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#endif
+
+namespace {
+  using any_ip_address = std::variant<tss::ip_address_v4_t, tss::ip_address_v6_t>;
+
+  /**
+   * Alternate between IPv6 and IPv4 addresses, starting with IPv6, but keep the order within each IP version.
+   */
+  std::vector<any_ip_address> interleave(gsl::span<any_ip_address const> const addresses)
+  {
+    std::vector<any_ip_address> v6{};
+    std::vector<any_ip_address> v4{};
+    for (auto const& address: addresses) {
+      (std::holds_alternative<tss::ip_address_v6_t>(address) ? v6 : v4).push_back(address);
+    }
+
+    std::vector<any_ip_address> ordered{};
+    ordered.reserve(addresses.size());
+    for (std::size_t i = 0U; i<std::max(v6.size(), v4.size()); ++i) {
+      if (i<v6.size()) {
+        ordered.push_back(v6[i]);
+      }
+      if (i<v4.size()) {
+        ordered.push_back(v4[i]);
+      }
+    }
+    return ordered;
+  }
+
+  /**
+   * Wait until one of the connecting sockets completes. Unlike select, poll takes descriptors of any value, which
+   * matters in processes holding thousands of sockets.
+   */
+  void wait(std::vector<pollfd>& targets, std::chrono::milliseconds const time_out)
+  {
+    auto const timeout_ms = static_cast<int>(std::max(time_out.count(), std::chrono::milliseconds::rep{0}));
+#if defined(_WIN32)
+    auto const result = ::WSAPoll(targets.data(), static_cast<ULONG>(targets.size()), timeout_ms);
+#else
+    auto const result = ::poll(targets.data(), static_cast<nfds_t>(targets.size()), timeout_ms);
+#endif
+    if (result==-1) {
+      if (auto const error = tss::error_code::last(); error!=tss::error_code::interrupted()) {
+        throw tss::socket_error{error.value()};
+      }
+    }
+  }
+
+  int pending_error(tss::native::socket_traits::socket_t const sock)
+  {
+    int error{};
+    auto len{static_cast<tss::native::socket_traits::socklen_t>(sizeof(error))};
+    if (::getsockopt(sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<tss::native::socket_traits::recv_buf_t>(&error),
+        &len)==-1) {
+      throw tss::socket_error{};
+    }
+    return error;
+  }
+
+  /**
+   * Create a non-blocking socket and start connecting it.
+   * @return The socket, unless connecting failed right away, in which case error is set.
+   */
+  std::optional<tss::any_tcp_socket> start(any_ip_address const& ip, tss::port_t const port, int& error)
+  {
+    return std::visit([port, &error](auto const& address) -> std::optional<tss::any_tcp_socket> {
+      using ip_t = std::decay_t<decltype(address)>;
+      using socket_t = std::conditional_t<std::is_same_v<ip_t, tss::ip_address_v6_t>, tss::tcp_socket_6,
+          tss::tcp_socket_4>;
+
+      socket_t sock{};
+      sock.set_non_blocking();
+      if (auto const connected = sock.connect(std::nothrow, {address, port});
+          !connected && !connected.error().in_progress()) {
+        error = connected.error().value();
+        return std::nullopt;
+      }
+      return tss::any_tcp_socket{std::in_place_type<socket_t>, std::move(sock)};
+    }, ip);
+  }
+
+  tss::native::socket_traits::socket_t native_handle(tss::any_tcp_socket const& sock) noexcept
+  {
+    return std::visit([](auto const& s) {
+      return s.native_handle();
+    }, sock);
+  }
+
+  tss::any_tcp_socket finish(tss::any_tcp_socket&& sock)
+  {
+    std::visit([](auto& s) {
+      s.set_non_blocking(false);
+    }, sock);
+    return std::move(sock);
+  }
+}
+
+namespace tss {
+  any_tcp_socket connect_any(
+      gsl::span<std::variant<ip_address_v4_t, ip_address_v6_t> const> const addresses,
+      port_t const port,
+      std::chrono::milliseconds const attempt_delay,
+      std::chrono::milliseconds const time_out
+  )
+  {
+    using clock = std::chrono::steady_clock;
+
+    auto const ordered = ::interleave(addresses);
+    auto const deadline = clock::now()+time_out;
+    auto next_attempt = clock::now();
+    int last_error{error_code::timed_out().value()};
+
+    // attempts are only ever appended, so a failed attempt just leaves an empty slot behind
+    std::vector<std::optional<any_tcp_socket>> attempts{};
+    attempts.reserve(ordered.size());
+    std::size_t started{0U};
+    std::size_t active{0U};
+
+    for (;;) {
+      auto const now = clock::now();
+      if (now>=deadline) {
+        throw socket_error{error_code::timed_out().value()};
+      }
+
+      if (started<ordered.size() && (active==0U || now>=next_attempt)) {
+        auto attempt = ::start(ordered[started++], port, last_error);
+        if (attempt) {
+          attempts.push_back(std::move(attempt));
+          ++active;
+          next_attempt = now+attempt_delay;
+        }
+        else {
+          // a failed attempt makes room for the next one right away
+          next_attempt = now;
+        }
+        continue;
+      }
+
+      if (active==0U) {
+        throw socket_error{last_error};
+      }
+
+      auto const wake_up = started<ordered.size() ? std::min(next_attempt, deadline) : deadline;
+      std::vector<pollfd> targets{};
+      for (auto const& attempt: attempts) {
+        if (attempt) {
+          targets.push_back(pollfd{::native_handle(*attempt), POLLOUT, 0});
+        }
+      }
+      // rounding up keeps the loop from spinning on a sub-millisecond remainder
+      ::wait(targets, std::chrono::ceil<std::chrono::milliseconds>(wake_up-now));
+
+      auto target = targets.begin();
+      for (auto& attempt: attempts) {
+        if (!attempt) {
+          continue;
+        }
+        // POLLERR and POLLHUP are reported without being asked for
+        auto const completed = target->revents!=0;
+        ++target;
+        if (!completed) {
+          continue;
+        }
+        if (auto const error = ::pending_error(::native_handle(*attempt)); error!=0) {
+          last_error = error;
+          attempt.reset();
+          --active;
+          continue;
+        }
+        return ::finish(std::move(*attempt));
+      }
+    }
+  }
+
+  any_tcp_socket connect_any(
+      std::string_view const host,
+      port_t const port,
+      std::chrono::milliseconds const attempt_delay,
+      std::chrono::milliseconds const time_out,
+      native::socket_api const& api
+  )
+  {
+    auto const addresses = resolve_ip_addresses(host, api);
+    return connect_any(addresses, port, attempt_delay, time_out);
+  }
+}
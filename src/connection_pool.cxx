@@ -0,0 +1,277 @@
+#include <tss/connection_pool.hxx>
+#include <tss/exceptions.hxx>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <unordered_map>
+
+#if defined(_WIN32)
+
+#include <tss/selector.hxx>
+
+#else
+
+#include <cerrno>
+
+#include <sys/socket.h>
+
+#endif
+
+namespace {
+  using clock = std::chrono::steady_clock;
+
+  template<typename TAddress>
+  struct address_hash final {
+    std::size_t operator()(TAddress const& address) const noexcept
+    {
+      std::size_t seed{std::hash<tss::port_t>{}(std::get<1U>(address))};
+      std::apply([&seed](auto const... parts) {
+        ((seed ^= std::hash<std::uint32_t>{}(parts)+0x9e3779b9U+(seed << 6U)+(seed >> 2U)), ...);
+      }, std::get<0U>(address));
+      return seed;
+    }
+  };
+
+  /**
+   * An idle connection is expected to be silent. Pending data or an end of stream means it cannot be reused.
+   */
+  template<typename TSocket>
+  bool is_alive(TSocket const& sock)
+  {
+#if defined(_WIN32)
+    tss::selector selector{};
+    selector.add_read(sock);
+    return selector.select()==0U;
+#else
+    std::byte probe{};
+    auto const result = ::recv(sock.native_handle(), &probe, sizeof(probe), MSG_PEEK | MSG_DONTWAIT);
+    return result==-1 && (errno==EAGAIN || errno==EWOULDBLOCK);
+#endif
+  }
+}
+
+namespace tss {
+  namespace detail {
+    template<ip_version_t TIP>
+    struct connection_pool_data final {
+      using socket_t = socket<TIP, protocol_t::TCP>;
+
+      struct idle_connection final {
+        socket_t sock;
+        clock::time_point since;
+      };
+
+      struct server final {
+        // most recently returned connections are at the back, where they are handed out again first
+        std::deque<idle_connection> idle{};
+        std::size_t open{0U};
+        // acquires blocked on this server, which keep it from being erased while they wait
+        std::size_t waiters{0U};
+      };
+
+      struct shard final {
+        std::mutex mutex{};
+        std::condition_variable available{};
+        std::unordered_map<address_t<TIP>, server, ::address_hash<address_t<TIP>>> servers{};
+      };
+
+      std::size_t max_per_server;
+      std::chrono::milliseconds idle_time_out;
+      std::deque<shard> shards;
+
+      connection_pool_data(
+          std::size_t const max_per_server,
+          std::chrono::milliseconds const idle_time_out,
+          std::size_t const shard_count
+      )
+          :max_per_server{max_per_server}, idle_time_out{idle_time_out}, shards(std::max(shard_count, std::size_t{1U}))
+      {
+      }
+
+      shard& shard_for(address_t<TIP> const& address) noexcept
+      {
+        return shards[::address_hash<address_t<TIP>>{}(address)%shards.size()];
+      }
+    };
+  }
+
+  template<ip_version_t TIP>
+  connection_pool<TIP>::lease::lease(connection_pool& pool, address_t<TIP> const& address, socket_t&& sock) noexcept
+      :pool_{&pool}, address_{address}, sock_{std::move(sock)}
+  {
+  }
+
+  template<ip_version_t TIP>
+  connection_pool<TIP>::lease::lease(lease&& src) noexcept
+      :pool_{std::exchange(src.pool_, nullptr)}, address_{src.address_}, sock_{std::move(src.sock_)}
+  {
+  }
+
+  template<ip_version_t TIP>
+  connection_pool<TIP>::lease::~lease() noexcept
+  {
+    if (pool_!=nullptr) {
+      pool_->give_back_(address_, std::move(sock_));
+    }
+  }
+
+  template<ip_version_t TIP>
+  void connection_pool<TIP>::lease::discard() noexcept
+  {
+    sock_.reset();
+  }
+
+  template<ip_version_t TIP>
+  typename connection_pool<TIP>::socket_t connection_pool<TIP>::lease::release() &&
+  {
+    auto sock{std::move(*sock_)};
+    sock_.reset();
+    std::exchange(pool_, nullptr)->give_back_(address_, std::nullopt);
+    return sock;
+  }
+
+  template<ip_version_t TIP>
+  connection_pool<TIP>::connection_pool(
+      std::size_t const max_per_server,
+      std::chrono::milliseconds const idle_time_out,
+      std::size_t const shards
+  )
+      :data_{std::make_unique<detail::connection_pool_data<TIP>>(max_per_server, idle_time_out, shards)}
+  {
+  }
+
+  template<ip_version_t TIP>
+  connection_pool<TIP>::~connection_pool() noexcept
+  = default;
+
+  template<ip_version_t TIP>
+  typename connection_pool<TIP>::lease
+  connection_pool<TIP>::acquire(address_t<TIP> const& address, std::chrono::milliseconds const wait)
+  {
+    auto& shard = data_->shard_for(address);
+    auto const deadline = clock::now()+wait;
+
+    std::unique_lock lock{shard.mutex};
+    for (;;) {
+      auto& server = shard.servers[address];
+      while (!server.idle.empty()) {
+        auto candidate{std::move(server.idle.back().sock)};
+        server.idle.pop_back();
+        if (::is_alive(candidate)) {
+          return lease{*this, address, std::move(candidate)};
+        }
+        --server.open;
+      }
+
+      if (server.open<data_->max_per_server) {
+        ++server.open;
+        break;
+      }
+
+      ++server.waiters;
+      auto const available = shard.available.wait_until(lock, deadline, [this, &server] {
+        return !server.idle.empty() || server.open<data_->max_per_server;
+      });
+      --server.waiters;
+      if (!available) {
+        throw socket_error{error_code::timed_out().value()};
+      }
+    }
+    lock.unlock();
+
+    // connecting takes a round trip, so the shard must not stay locked meanwhile
+    try {
+      socket_t sock{};
+      sock.connect(address);
+      return lease{*this, address, std::move(sock)};
+    }
+    catch (...) {
+      give_back_(address, std::nullopt);
+      throw;
+    }
+  }
+
+  template<ip_version_t TIP>
+  std::size_t connection_pool<TIP>::evict_idle()
+  {
+    auto const expired = clock::now()-data_->idle_time_out;
+    std::size_t evicted{0U};
+    for (auto& shard: data_->shards) {
+      std::lock_guard const lock{shard.mutex};
+      for (auto current = shard.servers.begin(); current!=shard.servers.end();) {
+        auto& server = current->second;
+        while (!server.idle.empty() && server.idle.front().since<=expired) {
+          server.idle.pop_front();
+          --server.open;
+          ++evicted;
+        }
+        current = server.open==0U && server.waiters==0U ? shard.servers.erase(current) : std::next(current);
+      }
+      shard.available.notify_all();
+    }
+    return evicted;
+  }
+
+  template<ip_version_t TIP>
+  std::size_t connection_pool<TIP>::idle() const
+  {
+    std::size_t count{0U};
+    for (auto& shard: data_->shards) {
+      std::lock_guard const lock{shard.mutex};
+      for (auto const& [address, server]: shard.servers) {
+        count += server.idle.size();
+      }
+    }
+    return count;
+  }
+
+  template<ip_version_t TIP>
+  std::size_t connection_pool<TIP>::size() const
+  {
+    std::size_t count{0U};
+    for (auto& shard: data_->shards) {
+      std::lock_guard const lock{shard.mutex};
+      for (auto const& [address, server]: shard.servers) {
+        count += server.open;
+      }
+    }
+    return count;
+  }
+
+  template<ip_version_t TIP>
+  void connection_pool<TIP>::give_back_(address_t<TIP> const& address, std::optional<socket_t> sock) noexcept
+  {
+    auto& shard = data_->shard_for(address);
+    {
+      std::lock_guard const lock{shard.mutex};
+      // servers with open connections are never erased, so the lookup cannot fail
+      auto& server = shard.servers.find(address)->second;
+      try {
+        if (sock && sock->is_valid()) {
+          server.idle.push_back({std::move(*sock), clock::now()});
+        }
+        else {
+          --server.open;
+        }
+      }
+      catch (std::bad_alloc const& ex) {
+        (void) ex;
+        --server.open;
+      }
+    }
+    // waiters for every server of the shard share the condition, so a single wakeup might reach the wrong one
+    shard.available.notify_all();
+  }
+
+  template
+  class connection_pool<ip_version_t::V4>;
+
+  template
+  class connection_pool<ip_version_t::V6>;
+}
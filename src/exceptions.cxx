@@ -62,6 +62,88 @@ namespace {
 }
 
 namespace tss {
+  error_code error_code::last() noexcept
+  {
+    return error_code{::last_error()};
+  }
+
+  error_code error_code::interrupted() noexcept
+  {
+#if defined(_WIN32)
+    return error_code{WSAEINTR};
+#else
+    return error_code{EINTR};
+#endif
+  }
+
+  error_code error_code::not_supported() noexcept
+  {
+#if defined(_WIN32)
+    return error_code{WSAEOPNOTSUPP};
+#else
+    return error_code{EOPNOTSUPP};
+#endif
+  }
+
+  error_code error_code::timed_out() noexcept
+  {
+#if defined(_WIN32)
+    return error_code{WSAETIMEDOUT};
+#else
+    return error_code{ETIMEDOUT};
+#endif
+  }
+
+  error_code error_code::no_buffer_space() noexcept
+  {
+#if defined(_WIN32)
+    return error_code{WSAENOBUFS};
+#else
+    return error_code{ENOBUFS};
+#endif
+  }
+
+  error_code error_code::invalid_argument() noexcept
+  {
+#if defined(_WIN32)
+    return error_code{WSAEINVAL};
+#else
+    return error_code{EINVAL};
+#endif
+  }
+
+  bool error_code::would_block() const noexcept
+  {
+#if defined(_WIN32)
+    return value_==WSAEWOULDBLOCK;
+#else
+    return value_==EAGAIN || value_==EWOULDBLOCK;
+#endif
+  }
+
+  bool error_code::in_progress() const noexcept
+  {
+#if defined(_WIN32)
+    return value_==WSAEWOULDBLOCK || value_==WSAEINPROGRESS;
+#else
+    return value_==EINPROGRESS;
+#endif
+  }
+
+  bool error_code::connection_aborted() const noexcept
+  {
+#if defined(_WIN32)
+    return value_==WSAECONNRESET;
+#else
+    return value_==ECONNABORTED || value_==EPROTO;
+#endif
+  }
+
+  std::string error_code::message() const
+  {
+    return ::error_string(value_);
+  }
+
   socket_error::socket_error()
       :socket_error{::last_error()}
   {
@@ -0,0 +1,198 @@
+#include <tss/framing.hxx>
+#include <tss/exceptions.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <gsl/assert>
+
+namespace {
+  bool is_valid_width(std::size_t const width) noexcept
+  {
+    return width==1U || width==2U || width==4U || width==8U;
+  }
+
+  std::size_t byte_index(tss::frame_format const& format, std::size_t const i) noexcept
+  {
+    // i counts from the least significant byte
+    return format.byte_order==std::endian::little ? i : format.header_width-1U-i;
+  }
+}
+
+namespace tss {
+  void encode_frame_header(frame_format const& format, std::size_t const length, mutable_buffer const header)
+  {
+    Expects(::is_valid_width(format.header_width) && header.size()>=format.header_width);
+    if (format.header_width<sizeof(std::uint64_t) &&
+        static_cast<std::uint64_t>(length) >> (8U*format.header_width)!=0U) {
+      throw frame_error{
+          "frame of " + std::to_string(length) + " bytes does not fit into a " +
+          std::to_string(format.header_width) + " byte header"
+      };
+    }
+
+    auto value = static_cast<std::uint64_t>(length);
+    for (std::size_t i = 0U; i<format.header_width; ++i) {
+      header[::byte_index(format, i)] = static_cast<std::byte>(value & 0xFFU);
+      value >>= 8U;
+    }
+  }
+
+  std::size_t decode_frame_header(frame_format const& format, const_buffer const header) noexcept
+  {
+    std::uint64_t value{0U};
+    for (std::size_t i = format.header_width; i>0U; --i) {
+      value = (value << 8U) | std::to_integer<std::uint64_t>(header[::byte_index(format, i-1U)]);
+    }
+    return static_cast<std::size_t>(value);
+  }
+
+  template<ip_version_t TIP>
+  frame_reader<TIP>::frame_reader(socket_t& sock, frame_format const& format, std::size_t const buffer_size)
+      :sock_{&sock}, format_{format}, buffer_(std::max(buffer_size, format.header_width))
+  {
+    Expects(::is_valid_width(format.header_width));
+  }
+
+  template<ip_version_t TIP>
+  std::optional<const_buffer> frame_reader<TIP>::receive()
+  {
+    for (;;) {
+      if (auto const frame = next()) {
+        return frame;
+      }
+
+      auto const received = fill(std::nothrow);
+      if (!received && received.error()==error_code::interrupted()) {
+        continue;
+      }
+      if (received.value()==0U) {
+        if (buffered()>0U) {
+          throw frame_error{"connection closed within a frame"};
+        }
+        return std::nullopt;
+      }
+    }
+  }
+
+  template<ip_version_t TIP>
+  std::optional<const_buffer> frame_reader<TIP>::next()
+  {
+    auto const size = frame_size_();
+    if (!size || *size>buffered()) {
+      return std::nullopt;
+    }
+
+    auto const frame = const_buffer{buffer_}.subspan(begin_+format_.header_width, *size-format_.header_width);
+    begin_ += *size;
+    return frame;
+  }
+
+  template<ip_version_t TIP>
+  result<std::size_t> frame_reader<TIP>::fill(std::nothrow_t) noexcept
+  {
+    if (begin_==end_) {
+      begin_ = 0U;
+      end_ = 0U;
+    }
+
+    // a partial frame only moves to the front when the rest of it would not fit behind it
+    auto const needed = needed_();
+    if (begin_+needed>buffer_.size() || end_==buffer_.size()) {
+      std::memmove(buffer_.data(), buffer_.data()+begin_, end_-begin_);
+      end_ -= begin_;
+      begin_ = 0U;
+    }
+
+    if (needed>buffer_.size() || end_==buffer_.size()) {
+      try {
+        buffer_.resize(std::max(needed, 2U*buffer_.size()));
+      }
+      catch (std::bad_alloc const&) {
+        return error_code::no_buffer_space();
+      }
+    }
+
+    auto const received = sock_->receive(std::nothrow, mutable_buffer{buffer_}.subspan(end_));
+    if (received) {
+      end_ += *received;
+    }
+    return received;
+  }
+
+  template<ip_version_t TIP>
+  std::optional<std::size_t> frame_reader<TIP>::frame_size_() const
+  {
+    if (buffered()<format_.header_width) {
+      return std::nullopt;
+    }
+
+    auto const length = decode_frame_header(format_, const_buffer{buffer_}.subspan(begin_));
+    if (length>format_.max_frame_size) {
+      throw frame_error{
+          "frame of " + std::to_string(length) + " bytes exceeds the maximum of " +
+          std::to_string(format_.max_frame_size) + " bytes"
+      };
+    }
+    return format_.header_width+length;
+  }
+
+  template<ip_version_t TIP>
+  std::size_t frame_reader<TIP>::needed_() const noexcept
+  {
+    if (buffered()<format_.header_width) {
+      return format_.header_width;
+    }
+
+    // oversized frames are rejected by next, so the buffer never grows beyond the limit
+    auto const length = decode_frame_header(format_, const_buffer{buffer_}.subspan(begin_));
+    return format_.header_width+std::min(length, format_.max_frame_size);
+  }
+
+  template<ip_version_t TIP>
+  frame_writer<TIP>::frame_writer(socket_t& sock, frame_format const& format)
+      :sock_{&sock}, format_{format}
+  {
+    Expects(::is_valid_width(format.header_width));
+  }
+
+  template<ip_version_t TIP>
+  void frame_writer<TIP>::send(const_buffer const payload)
+  {
+    send(gsl::span<const_buffer const>{&payload, 1U});
+  }
+
+  template<ip_version_t TIP>
+  void frame_writer<TIP>::send(gsl::span<const_buffer const> const payloads)
+  {
+    // all headers are encoded before the first send, so a payload that is too large leaves the stream intact
+    headers_.resize(payloads.size());
+    buffers_.clear();
+    for (std::size_t i = 0U; i<payloads.size(); ++i) {
+      encode_frame_header(format_, payloads[i].size(), mutable_buffer{headers_[i]});
+      buffers_.emplace_back(headers_[i].data(), format_.header_width);
+      if (!payloads[i].empty()) {
+        buffers_.push_back(payloads[i]);
+      }
+    }
+
+    auto remaining = gsl::span<const_buffer>{buffers_};
+    while (!remaining.empty()) {
+      auto const batch = remaining.first(std::min(remaining.size(), max_vectored_buffers));
+      remaining = remaining_buffers(remaining, sock_->send_vectored(batch));
+    }
+  }
+
+  template
+  class frame_reader<ip_version_t::V4>;
+
+  template
+  class frame_reader<ip_version_t::V6>;
+
+  template
+  class frame_writer<ip_version_t::V4>;
+
+  template
+  class frame_writer<ip_version_t::V6>;
+}
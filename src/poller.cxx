@@ -0,0 +1,158 @@
+#include <tss/poller.hxx>
+#include <tss/exceptions.hxx>
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+  std::uint32_t make_native_events(tss::poll_event_t const events, tss::trigger_t const trigger) noexcept
+  {
+    std::uint32_t native_events{0U};
+    if ((events & tss::poll_event_t::Read)!=tss::poll_event_t::None) {
+      native_events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if ((events & tss::poll_event_t::Write)!=tss::poll_event_t::None) {
+      native_events |= EPOLLOUT;
+    }
+
+    switch (trigger) {
+    case tss::trigger_t::Edge:
+      native_events |= EPOLLET;
+      break;
+    case tss::trigger_t::OneShot:
+      native_events |= EPOLLONESHOT;
+      break;
+    default:
+      break;
+    }
+
+    return native_events;
+  }
+
+  tss::poll_event_t make_events(std::uint32_t const native_events) noexcept
+  {
+    auto events{tss::poll_event_t::None};
+    if ((native_events & EPOLLIN)!=0U) {
+      events = events | tss::poll_event_t::Read;
+    }
+    if ((native_events & EPOLLOUT)!=0U) {
+      events = events | tss::poll_event_t::Write;
+    }
+    if ((native_events & EPOLLERR)!=0U) {
+      events = events | tss::poll_event_t::Error;
+    }
+    if ((native_events & (EPOLLHUP | EPOLLRDHUP))!=0U) {
+      events = events | tss::poll_event_t::HangUp;
+    }
+    return events;
+  }
+}
+
+namespace tss {
+  namespace detail {
+    struct poller_data final {
+      int epoll_fd{-1};
+      std::size_t registered{0U};
+      std::vector<epoll_event> native_events{};
+      std::vector<poller::event> ready{};
+      // indexed by descriptor, which the kernel always allocates as small as possible
+      std::vector<void*> user_data{};
+    };
+  }
+
+  poller::poller(std::size_t const max_events, native::socket_api const&)
+      :data_{std::make_unique<detail::poller_data>()}
+  {
+    data_->epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (data_->epoll_fd==-1) {
+      throw socket_error{};
+    }
+    data_->native_events.resize(std::max<std::size_t>(max_events, 1U));
+    data_->ready.reserve(data_->native_events.size());
+  }
+
+  poller::~poller() noexcept
+  {
+    ::close(data_->epoll_fd);
+  }
+
+  void poller::add_(traits::socket_t const sock, poll_event_t const events, void* const user_data,
+      trigger_t const trigger)
+  {
+    epoll_event native_event{};
+    native_event.events = ::make_native_events(events, trigger);
+    native_event.data.fd = sock;
+    if (::epoll_ctl(data_->epoll_fd, EPOLL_CTL_ADD, sock, &native_event)==-1) {
+      throw socket_error{};
+    }
+
+    auto const index = static_cast<std::size_t>(sock);
+    if (index>=data_->user_data.size()) {
+      data_->user_data.resize(index+1U);
+    }
+    data_->user_data[index] = user_data;
+    ++data_->registered;
+  }
+
+  void poller::modify_(traits::socket_t const sock, poll_event_t const events, void* const user_data,
+      trigger_t const trigger)
+  {
+    epoll_event native_event{};
+    native_event.events = ::make_native_events(events, trigger);
+    native_event.data.fd = sock;
+    if (::epoll_ctl(data_->epoll_fd, EPOLL_CTL_MOD, sock, &native_event)==-1) {
+      throw socket_error{};
+    }
+    data_->user_data[static_cast<std::size_t>(sock)] = user_data;
+  }
+
+  void poller::remove_(traits::socket_t const sock)
+  {
+    if (::epoll_ctl(data_->epoll_fd, EPOLL_CTL_DEL, sock, nullptr)==-1) {
+      throw socket_error{};
+    }
+    data_->user_data[static_cast<std::size_t>(sock)] = nullptr;
+    --data_->registered;
+  }
+
+  gsl::span<poller::event const> poller::wait(std::chrono::milliseconds const time_out)
+  {
+    static auto constexpr max_time_out = static_cast<std::chrono::milliseconds::rep>(std::numeric_limits<int>::max());
+    auto const native_time_out = time_out.count()<0 ? -1 : static_cast<int>(std::min(time_out.count(), max_time_out));
+
+    auto& native_events = data_->native_events;
+    auto const result = ::epoll_wait(data_->epoll_fd, native_events.data(), static_cast<int>(native_events.size()),
+        native_time_out);
+    if (result==-1) {
+      if (errno==EINTR) {
+        return {};
+      }
+      throw socket_error{};
+    }
+
+    auto& ready = data_->ready;
+    ready.clear();
+    for (auto const& native_event: gsl::span<epoll_event const>{native_events.data(), static_cast<std::size_t>(result)}) {
+      auto const sock = native_event.data.fd;
+      ready.push_back({sock, ::make_events(native_event.events),
+          data_->user_data[static_cast<std::size_t>(sock)]});
+    }
+
+    // a full buffer means there may be more ready sockets than we could report, so grow for the next round
+    if (static_cast<std::size_t>(result)==native_events.size() && native_events.size()<data_->registered) {
+      native_events.resize(std::min(native_events.size()*2U, data_->registered));
+    }
+
+    return ready;
+  }
+
+  std::size_t poller::size() const noexcept
+  {
+    return data_->registered;
+  }
+}
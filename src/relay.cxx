@@ -0,0 +1,265 @@
+#include <tss/relay.hxx>
+#include <tss/exceptions.hxx>
+#include <tss/poller.hxx>
+
+#include <array>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+  void throw_pending_error(int const sock)
+  {
+    int error{};
+    auto len{static_cast<socklen_t>(sizeof(error))};
+    if (::getsockopt(sock, SOL_SOCKET, SO_ERROR, &error, &len)==-1) {
+      throw tss::socket_error{};
+    }
+    if (error!=0) {
+      throw tss::socket_error{error};
+    }
+  }
+}
+
+namespace tss {
+  namespace detail {
+    /**
+     * One direction of a relay, moving bytes from a source socket through a pipe into a destination socket.
+     */
+    struct relay_direction final {
+      std::array<int, 2U> pipe{-1, -1};
+      std::size_t capacity{0U};
+      std::size_t buffered{0U};
+      std::uint64_t forwarded{0U};
+      bool end_of_stream{false};
+      bool shut_down{false};
+
+      explicit relay_direction(std::size_t const pipe_size)
+      {
+        if (::pipe2(pipe.data(), O_NONBLOCK | O_CLOEXEC)==-1) {
+          throw socket_error{};
+        }
+        if (pipe_size>0U) {
+          // the kernel might refuse, e.g. if the size exceeds the limit for unprivileged users
+          (void) ::fcntl(pipe[1U], F_SETPIPE_SZ, static_cast<int>(pipe_size));
+        }
+        auto const size = ::fcntl(pipe[1U], F_GETPIPE_SZ);
+        if (size==-1) {
+          close();
+          throw socket_error{};
+        }
+        capacity = static_cast<std::size_t>(size);
+      }
+
+      relay_direction(relay_direction const&) = delete;
+
+      relay_direction& operator=(relay_direction const&) = delete;
+
+      ~relay_direction() noexcept
+      {
+        close();
+      }
+
+      void close() noexcept
+      {
+        for (auto& fd: pipe) {
+          if (fd!=-1) {
+            ::close(fd);
+            fd = -1;
+          }
+        }
+      }
+
+      [[nodiscard]] bool wants_input() const noexcept
+      {
+        return !end_of_stream && buffered<capacity;
+      }
+
+      [[nodiscard]] bool wants_output() const noexcept
+      {
+        return buffered>0U;
+      }
+
+      [[nodiscard]] bool is_done() const noexcept
+      {
+        return shut_down;
+      }
+
+      [[nodiscard]] bool needs_shut_down() const noexcept
+      {
+        return end_of_stream && buffered==0U && !shut_down;
+      }
+
+      /**
+       * Move bytes until neither the source nor the destination makes progress.
+       * @return The number of bytes that reached the destination.
+       */
+      std::size_t pump(int const source, int const destination)
+      {
+        std::size_t moved{0U};
+        for (bool progress = true; progress;) {
+          progress = false;
+
+          if (wants_input()) {
+            auto const result = ::splice(source, nullptr, pipe[1U], nullptr, capacity-buffered,
+                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (result>0) {
+              buffered += static_cast<std::size_t>(result);
+              progress = true;
+            }
+            else if (result==0) {
+              end_of_stream = true;
+            }
+            else if (errno!=EAGAIN && errno!=EINTR) {
+              throw socket_error{};
+            }
+          }
+
+          if (wants_output()) {
+            auto const result = ::splice(pipe[0U], nullptr, destination, nullptr, buffered,
+                SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+            if (result>0) {
+              buffered -= static_cast<std::size_t>(result);
+              forwarded += static_cast<std::uint64_t>(result);
+              moved += static_cast<std::size_t>(result);
+              progress = true;
+            }
+            else if (result==-1 && errno!=EAGAIN && errno!=EINTR) {
+              throw socket_error{};
+            }
+          }
+        }
+        return moved;
+      }
+    };
+
+    struct relay_data final {
+      relay_direction first_to_second;
+      relay_direction second_to_first;
+      tss::poller poller{2U};
+
+      explicit relay_data(std::size_t const pipe_size)
+          :first_to_second{pipe_size}, second_to_first{pipe_size}
+      {
+      }
+    };
+  }
+
+  template<ip_version_t TIP>
+  relay<TIP>::relay(
+      socket<TIP, protocol_t::TCP>& first,
+      socket<TIP, protocol_t::TCP>& second,
+      std::size_t const pipe_size
+  )
+      :first_{first}, second_{second}, data_{std::make_unique<detail::relay_data>(pipe_size)}
+  {
+    first_.set_non_blocking();
+    second_.set_non_blocking();
+    data_->poller.add(first_, poll_event_t::None);
+    data_->poller.add(second_, poll_event_t::None);
+  }
+
+  template<ip_version_t TIP>
+  relay<TIP>::~relay() noexcept
+  {
+    try {
+      data_->poller.remove(first_);
+      data_->poller.remove(second_);
+    }
+    catch (socket_error const& ex) {
+      (void) ex;
+    }
+  }
+
+  template<ip_version_t TIP>
+  std::size_t relay<TIP>::pump()
+  {
+    auto& forward = data_->first_to_second;
+    auto& backward = data_->second_to_first;
+
+    auto const moved = forward.pump(first_.native_handle(), second_.native_handle())+
+        backward.pump(second_.native_handle(), first_.native_handle());
+
+    if (forward.needs_shut_down()) {
+      second_.shutdown(shutdown_t::Write);
+      forward.shut_down = true;
+    }
+    if (backward.needs_shut_down()) {
+      first_.shutdown(shutdown_t::Write);
+      backward.shut_down = true;
+    }
+    return moved;
+  }
+
+  template<ip_version_t TIP>
+  bool relay<TIP>::run(std::chrono::milliseconds const time_out)
+  {
+    auto const deadline = std::chrono::steady_clock::now()+time_out;
+    auto const& forward = data_->first_to_second;
+    auto const& backward = data_->second_to_first;
+
+    for (;;) {
+      pump();
+      if (is_done()) {
+        return true;
+      }
+
+      auto first_events{poll_event_t::None};
+      auto second_events{poll_event_t::None};
+      if (forward.wants_input()) {
+        first_events = first_events | poll_event_t::Read;
+      }
+      if (forward.wants_output()) {
+        second_events = second_events | poll_event_t::Write;
+      }
+      if (backward.wants_input()) {
+        second_events = second_events | poll_event_t::Read;
+      }
+      if (backward.wants_output()) {
+        first_events = first_events | poll_event_t::Write;
+      }
+      data_->poller.modify(first_, first_events);
+      data_->poller.modify(second_, second_events);
+
+      auto remaining{std::chrono::milliseconds{-1}};
+      if (time_out.count()>=0) {
+        remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline-std::chrono::steady_clock::now());
+        if (remaining.count()<=0) {
+          return false;
+        }
+      }
+
+      for (auto const& event: data_->poller.wait(remaining)) {
+        if (event.is_error()) {
+          ::throw_pending_error(event.socket);
+        }
+      }
+    }
+  }
+
+  template<ip_version_t TIP>
+  bool relay<TIP>::is_done() const noexcept
+  {
+    return data_->first_to_second.is_done() && data_->second_to_first.is_done();
+  }
+
+  template<ip_version_t TIP>
+  std::uint64_t relay<TIP>::first_to_second() const noexcept
+  {
+    return data_->first_to_second.forwarded;
+  }
+
+  template<ip_version_t TIP>
+  std::uint64_t relay<TIP>::second_to_first() const noexcept
+  {
+    return data_->second_to_first.forwarded;
+  }
+
+  template
+  class relay<ip_version_t::V4>;
+
+  template
+  class relay<ip_version_t::V6>;
+}
@@ -0,0 +1,215 @@
+#include <tss/resolver.hxx>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+  template<typename TAddresses>
+  TAddresses deduplicate(TAddresses addresses)
+  {
+    auto end = addresses.begin();
+    for (auto current = addresses.begin(); current!=addresses.end(); ++current) {
+      if (std::find(addresses.begin(), end, *current)==end) {
+        *end++ = std::move(*current);
+      }
+    }
+    addresses.erase(end, addresses.end());
+    return addresses;
+  }
+}
+
+namespace tss {
+  namespace detail {
+    template<typename TAddresses>
+    struct resolver_cache final {
+      struct entry final {
+        std::shared_future<TAddresses> result;
+        // pending lookups never expire, the worker sets the time once the lookup finished
+        std::chrono::steady_clock::time_point expires;
+        std::uint64_t generation;
+      };
+
+      std::unordered_map<std::string, entry> entries{};
+
+      void purge(std::chrono::steady_clock::time_point const now)
+      {
+        std::erase_if(entries, [now](auto const& item) {
+          return item.second.expires<=now;
+        });
+      }
+    };
+
+    struct resolver_data final {
+      std::chrono::seconds time_to_live;
+      mutable std::mutex mutex{};
+      std::condition_variable wake{};
+      std::deque<std::function<void()>> jobs{};
+      bool stopping{false};
+      std::uint64_t generation{0U};
+      resolver_cache<resolver::v4_addresses_t> v4{};
+      resolver_cache<resolver::v6_addresses_t> v6{};
+      resolver_cache<resolver::addresses_t> mixed{};
+      std::vector<std::thread> workers{};
+
+      explicit resolver_data(std::chrono::seconds const ttl)
+          :time_to_live{ttl}
+      {
+      }
+
+      void work()
+      {
+        for (;;) {
+          std::function<void()> job{};
+          {
+            std::unique_lock lock{mutex};
+            wake.wait(lock, [this] {
+              return stopping || !jobs.empty();
+            });
+            if (stopping) {
+              return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+          }
+          job();
+        }
+      }
+
+      template<typename TAddresses, typename TResolve>
+      std::shared_future<TAddresses>
+      lookup(resolver_cache<TAddresses>& cache, std::string_view const host, TResolve resolve)
+      {
+        std::lock_guard const lock{mutex};
+        std::string key{host};
+        if (auto const found = cache.entries.find(key);
+            found!=cache.entries.end() && found->second.expires>std::chrono::steady_clock::now()) {
+          return found->second.result;
+        }
+
+        auto const promise = std::make_shared<std::promise<TAddresses>>();
+        std::shared_future<TAddresses> result{promise->get_future()};
+        auto const id = ++generation;
+        cache.entries.insert_or_assign(key, typename resolver_cache<TAddresses>::entry{
+            result, std::chrono::steady_clock::time_point::max(), id
+        });
+
+        jobs.emplace_back([this, &cache, key = std::move(key), promise, id, resolve] {
+          try {
+            auto addresses = ::deduplicate(resolve(key));
+            finish(cache, key, id, true);
+            promise->set_value(std::move(addresses));
+          }
+          catch (...) {
+            finish(cache, key, id, false);
+            promise->set_exception(std::current_exception());
+          }
+        });
+        wake.notify_one();
+        return result;
+      }
+
+      template<typename TAddresses>
+      void finish(resolver_cache<TAddresses>& cache, std::string const& key, std::uint64_t const id, bool const keep)
+      {
+        std::lock_guard const lock{mutex};
+        auto const found = cache.entries.find(key);
+        // the entry might have been cleared or replaced in the meantime
+        if (found==cache.entries.end() || found->second.generation!=id) {
+          return;
+        }
+        if (keep) {
+          found->second.expires = std::chrono::steady_clock::now()+time_to_live;
+        }
+        else {
+          cache.entries.erase(found);
+        }
+      }
+    };
+  }
+
+  resolver::resolver(std::size_t const threads, std::chrono::seconds const time_to_live, native::socket_api const&)
+      :data_{std::make_unique<detail::resolver_data>(time_to_live)}
+  {
+    auto const count = std::max(threads, std::size_t{1U});
+    data_->workers.reserve(count);
+    for (std::size_t i = 0U; i<count; ++i) {
+      data_->workers.emplace_back([data = data_.get()] {
+        data->work();
+      });
+    }
+  }
+
+  resolver::~resolver() noexcept
+  {
+    {
+      std::lock_guard const lock{data_->mutex};
+      data_->stopping = true;
+    }
+    data_->wake.notify_all();
+    for (auto& worker: data_->workers) {
+      worker.join();
+    }
+  }
+
+  std::shared_future<resolver::v4_addresses_t> resolver::resolve_v4(std::string_view const host)
+  {
+    return data_->lookup(data_->v4, host, [](std::string const& name) {
+      return resolve_ip_addresses_v4(name);
+    });
+  }
+
+  std::shared_future<resolver::v6_addresses_t> resolver::resolve_v6(std::string_view const host)
+  {
+    return data_->lookup(data_->v6, host, [](std::string const& name) {
+      return resolve_ip_addresses_v6(name);
+    });
+  }
+
+  std::shared_future<resolver::addresses_t> resolver::resolve(std::string_view const host)
+  {
+    return data_->lookup(data_->mixed, host, [](std::string const& name) {
+      return resolve_ip_addresses(name);
+    });
+  }
+
+  std::vector<std::shared_future<resolver::addresses_t>>
+  resolver::resolve(gsl::span<std::string_view const> const hosts)
+  {
+    std::vector<std::shared_future<addresses_t>> results{};
+    results.reserve(hosts.size());
+    for (auto const host: hosts) {
+      results.push_back(resolve(host));
+    }
+    return results;
+  }
+
+  void resolver::purge()
+  {
+    std::lock_guard const lock{data_->mutex};
+    auto const now = std::chrono::steady_clock::now();
+    data_->v4.purge(now);
+    data_->v6.purge(now);
+    data_->mixed.purge(now);
+  }
+
+  void resolver::clear()
+  {
+    std::lock_guard const lock{data_->mutex};
+    data_->v4.entries.clear();
+    data_->v6.entries.clear();
+    data_->mixed.entries.clear();
+  }
+
+  std::size_t resolver::size() const
+  {
+    std::lock_guard const lock{data_->mutex};
+    return data_->v4.entries.size()+data_->v6.entries.size()+data_->mixed.entries.size();
+  }
+}
@@ -0,0 +1,85 @@
+#include <tss/sharded_listener.hxx>
+#include <tss/exceptions.hxx>
+
+#include <array>
+
+#include <linux/filter.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+
+#include <gsl/assert>
+
+namespace {
+  /**
+   * Attach a classic BPF program returning the index of the receiving CPU modulo the number of shards.
+   */
+  void attach_cpu_steering(int const sock, std::size_t const shards)
+  {
+    std::array<sock_filter, 3U> code{{
+        {BPF_LD | BPF_W | BPF_ABS, 0U, 0U, static_cast<std::uint32_t>(SKF_AD_OFF+SKF_AD_CPU)},
+        {BPF_ALU | BPF_MOD | BPF_K, 0U, 0U, static_cast<std::uint32_t>(shards)},
+        {BPF_RET | BPF_A, 0U, 0U, 0U},
+    }};
+    sock_fprog const program{static_cast<unsigned short>(code.size()), code.data()};
+    if (::setsockopt(sock, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program))==-1) {
+      throw tss::socket_error{};
+    }
+  }
+}
+
+namespace tss {
+  template<ip_version_t TIP, protocol_t TProto>
+  sharded_listener<TIP, TProto>::sharded_listener(
+      address_t<TIP> const& address,
+      std::size_t const shards,
+      steering_t const steering,
+      std::uint32_t const backlog
+  )
+  {
+    Expects(shards>0U);
+
+    shards_.reserve(shards);
+    for (std::size_t i = 0U; i<shards; ++i) {
+      auto& sock = shards_.emplace_back();
+      sock.set_reuse_port();
+      sock.bind(address);
+      // the program applies to the whole group, so attaching it once after the first bind is enough
+      if (i==0U && steering==steering_t::Cpu) {
+        ::attach_cpu_steering(sock.native_handle(), shards);
+      }
+    }
+
+    // listening only after all shards are bound keeps connections from piling up in the first shard
+    if constexpr (TProto==protocol_t::TCP) {
+      for (auto& sock: shards_) {
+        sock.listen(backlog);
+      }
+    }
+    else {
+      (void) backlog;
+    }
+  }
+
+  void pin_current_thread(std::size_t const cpu)
+  {
+    cpu_set_t set{};
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (auto const result = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set); result!=0) {
+      throw socket_error{result};
+    }
+  }
+
+  template
+  class sharded_listener<ip_version_t::V4, protocol_t::TCP>;
+
+  template
+  class sharded_listener<ip_version_t::V4, protocol_t::UDP>;
+
+  template
+  class sharded_listener<ip_version_t::V6, protocol_t::TCP>;
+
+  template
+  class sharded_listener<ip_version_t::V6, protocol_t::UDP>;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <tss/address.hxx>
+#include <tss/enums.hxx>
+
+#include <type_traits>
+
+#if defined(_WIN32)
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+
+#include <Windows.h>
+#include <WinSock2.h>
+#include <ws2ipdef.h>
+
+#else
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#endif
+
+namespace tss::detail {
+  template<tss::ip_version_t TIP>
+  inline auto constexpr af = AF_INET;
+
+  template<>
+  inline auto constexpr af<tss::ip_version_t::V6> = AF_INET6;
+
+  template<tss::ip_version_t TIP>
+  using sockaddr_t = std::conditional_t<TIP==tss::ip_version_t::V6, sockaddr_in6, sockaddr_in>;
+
+  template<tss::protocol_t TProto>
+  inline auto constexpr type = SOCK_STREAM;
+
+  template<>
+  inline auto constexpr type<tss::protocol_t::UDP> = SOCK_DGRAM;
+
+  template<tss::protocol_t TProto>
+  inline auto constexpr proto = IPPROTO_TCP;
+
+  template<>
+  inline auto constexpr proto<tss::protocol_t::UDP> = IPPROTO_UDP;
+
+#if defined(_WIN32)
+#define W u.Word
+#else
+#define W s6_addr16
+#endif
+
+  inline in6_addr make_in_addr(tss::ip_address_v6_t const& ip) noexcept
+  {
+    in6_addr addr{};
+    addr.W[0] = htons(std::get<0U>(ip));
+    addr.W[1] = htons(std::get<1U>(ip));
+    addr.W[2] = htons(std::get<2U>(ip));
+    addr.W[3] = htons(std::get<3U>(ip));
+    addr.W[4] = htons(std::get<4U>(ip));
+    addr.W[5] = htons(std::get<5U>(ip));
+    addr.W[6] = htons(std::get<6U>(ip));
+    addr.W[7] = htons(std::get<7U>(ip));
+    return addr;
+  }
+
+  inline tss::ip_address_v6_t make_ip_address(in6_addr const& addr) noexcept
+  {
+    return {
+        ntohs(addr.W[0]),
+        ntohs(addr.W[1]),
+        ntohs(addr.W[2]),
+        ntohs(addr.W[3]),
+        ntohs(addr.W[4]),
+        ntohs(addr.W[5]),
+        ntohs(addr.W[6]),
+        ntohs(addr.W[7]),
+    };
+  }
+
+#undef W
+
+  inline sockaddr_in6 make_sock_addr(tss::address_v6_t const& addr) noexcept
+  {
+    auto const [ip, port] = addr;
+
+    sockaddr_in6 result{};
+    result.sin6_family = AF_INET6;
+    result.sin6_addr = make_in_addr(ip);
+    result.sin6_port = htons(port);
+    return result;
+  }
+
+  inline tss::address_v6_t make_address(sockaddr_in6 const& addr) noexcept
+  {
+    return {
+        make_ip_address(addr.sin6_addr),
+        ntohs(addr.sin6_port),
+    };
+  }
+
+  inline in_addr make_in_addr(tss::ip_address_v4_t const& ip) noexcept
+  {
+    std::uint32_t const full{
+        (static_cast<std::uint32_t>(std::get<0U>(ip)) << 24U) |
+            (static_cast<std::uint32_t>(std::get<1U>(ip)) << 16U) |
+            (static_cast<std::uint32_t>(std::get<2U>(ip)) << 8U) |
+            static_cast<std::uint32_t>(std::get<3U>(ip))
+    };
+
+    in_addr addr{};
+    addr.s_addr = htonl(full);
+    return addr;
+  }
+
+  inline tss::ip_address_v4_t make_ip_address(in_addr const& addr) noexcept
+  {
+    std::uint32_t const full{ntohl(addr.s_addr)};
+
+    return {
+        static_cast<std::uint8_t>(full >> 24U),
+        static_cast<std::uint8_t>(full >> 16U),
+        static_cast<std::uint8_t>(full >> 8U),
+        static_cast<std::uint8_t>(full),
+    };
+  }
+
+  inline sockaddr_in make_sock_addr(tss::address_v4_t const& addr) noexcept
+  {
+    auto const [ip, port] = addr;
+
+    sockaddr_in result{};
+    result.sin_family = AF_INET;
+    result.sin_addr = make_in_addr(ip);
+    result.sin_port = htons(port);
+    return result;
+  }
+
+  inline tss::address_v4_t make_address(sockaddr_in const& addr) noexcept
+  {
+    return {
+        make_ip_address(addr.sin_addr),
+        ntohs(addr.sin_port),
+    };
+  }
+}
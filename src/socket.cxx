@@ -1,7 +1,15 @@
 #include <tss/socket.hxx>
 #include <tss/exceptions.hxx>
 
+#include "sockaddr.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <limits>
+#include <optional>
 
 #if defined(_WIN32)
 
@@ -15,134 +23,127 @@
 #else
 
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <netinet/udp.h>
+#include <sys/sendfile.h>
 #endif
 
-#include <gsl/assert>
-
-namespace {
-  template<tss::ip_version_t TIP>
-  inline auto constexpr af = AF_INET;
-
-  template<>
-  inline auto constexpr af<tss::ip_version_t::V6> = AF_INET6;
-
-  template<tss::ip_version_t TIP>
-  using sockaddr_t = std::conditional_t<TIP==tss::ip_version_t::V6, sockaddr_in6, sockaddr_in>;
-
-  template<tss::protocol_t TProto>
-  inline auto constexpr type = SOCK_STREAM;
-
-  template<>
-  inline auto constexpr type<tss::protocol_t::UDP> = SOCK_DGRAM;
-
-  template<tss::protocol_t TProto>
-  inline auto constexpr proto = IPPROTO_TCP;
-
-  template<>
-  inline auto constexpr proto<tss::protocol_t::UDP> = IPPROTO_UDP;
-
-#if defined(_WIN32)
-#define W u.Word
-#else
-#define W s6_addr16
 #endif
 
-  in6_addr make_in_addr(tss::ip_address_v6_t const& ip) noexcept
-  {
-    in6_addr addr{};
-    addr.W[0] = htons(std::get<0U>(ip));
-    addr.W[1] = htons(std::get<1U>(ip));
-    addr.W[2] = htons(std::get<2U>(ip));
-    addr.W[3] = htons(std::get<3U>(ip));
-    addr.W[4] = htons(std::get<4U>(ip));
-    addr.W[5] = htons(std::get<5U>(ip));
-    addr.W[6] = htons(std::get<6U>(ip));
-    addr.W[7] = htons(std::get<7U>(ip));
-    return addr;
-  }
-
-  tss::ip_address_v6_t make_ip_address(in6_addr const& addr) noexcept
-  {
-    return {
-        ntohs(addr.W[0]),
-        ntohs(addr.W[1]),
-        ntohs(addr.W[2]),
-        ntohs(addr.W[3]),
-        ntohs(addr.W[4]),
-        ntohs(addr.W[5]),
-        ntohs(addr.W[6]),
-        ntohs(addr.W[7]),
-    };
-  }
-
-#undef W
-
-  sockaddr_in6 make_sock_addr(tss::address_v6_t const& addr) noexcept
-  {
-    auto const [ip, port] = addr;
-
-    sockaddr_in6 result{};
-    result.sin6_family = AF_INET6;
-    result.sin6_addr = make_in_addr(ip);
-    result.sin6_port = htons(port);
-    return result;
-  }
+#include <gsl/assert>
 
-  tss::address_v6_t make_address(sockaddr_in6 const& addr) noexcept
+namespace {
+  template<typename TBuffer>
+  tss::vectored_progress make_progress(gsl::span<TBuffer const> const buffers, std::size_t const bytes) noexcept
   {
-    return {
-        make_ip_address(addr.sin6_addr),
-        ntohs(addr.sin6_port),
-    };
+    tss::vectored_progress progress{bytes, 0U, 0U};
+    auto remaining{bytes};
+    for (auto const& buffer: buffers) {
+      if (remaining<buffer.size()) {
+        progress.offset = remaining;
+        break;
+      }
+      remaining -= buffer.size();
+      ++progress.buffers;
+    }
+    return progress;
   }
 
-  in_addr make_in_addr(tss::ip_address_v4_t const& ip) noexcept
+#if defined(__linux__)
+  std::optional<std::chrono::nanoseconds> to_duration(timespec const& time) noexcept
   {
-    std::uint32_t const full{
-        (static_cast<std::uint32_t>(std::get<0U>(ip)) << 24U) |
-            (static_cast<std::uint32_t>(std::get<1U>(ip)) << 16U) |
-            (static_cast<std::uint32_t>(std::get<2U>(ip)) << 8U) |
-            static_cast<std::uint32_t>(std::get<3U>(ip))
-    };
-
-    in_addr addr{};
-    addr.s_addr = htonl(full);
-    return addr;
+    if (time.tv_sec==0 && time.tv_nsec==0) {
+      return std::nullopt;
+    }
+    return std::chrono::seconds{time.tv_sec}+std::chrono::nanoseconds{time.tv_nsec};
   }
 
-  tss::ip_address_v4_t make_ip_address(in_addr const& addr) noexcept
+  /**
+   * Extract the SCM_TIMESTAMPING control message, which holds the software timestamp first and the raw hardware
+   * timestamp last.
+   */
+  tss::timestamps find_timestamps(msghdr& message) noexcept
   {
-    std::uint32_t const full{ntohl(addr.s_addr)};
-
-    return {
-        static_cast<std::uint8_t>(full >> 24U),
-        static_cast<std::uint8_t>(full >> 16U),
-        static_cast<std::uint8_t>(full >> 8U),
-        static_cast<std::uint8_t>(full),
-    };
+    tss::timestamps time{};
+    for (auto* header = CMSG_FIRSTHDR(&message); header!=nullptr; header = CMSG_NXTHDR(&message, header)) {
+      if (header->cmsg_level==SOL_SOCKET && header->cmsg_type==SCM_TIMESTAMPING) {
+        scm_timestamping stamps{};
+        std::memcpy(&stamps, CMSG_DATA(header), sizeof(stamps));
+        time.software = ::to_duration(stamps.ts[0U]);
+        time.hardware = ::to_duration(stamps.ts[2U]);
+      }
+    }
+    return time;
   }
+#endif
 
-  sockaddr_in make_sock_addr(tss::address_v4_t const& addr) noexcept
-  {
-    auto const [ip, port] = addr;
-
-    sockaddr_in result{};
-    result.sin_family = AF_INET;
-    result.sin_addr = make_in_addr(ip);
-    result.sin_port = htons(port);
-    return result;
-  }
+  struct native_option final {
+    int level;
+    int name;
+  };
 
-  tss::address_v4_t make_address(sockaddr_in const& addr) noexcept
+  /**
+   * Map an option to its level and name, or nothing if the platform does not support it.
+   */
+  std::optional<native_option> to_native(tss::option_t const option) noexcept
   {
-    return {
-        make_ip_address(addr.sin_addr),
-        ntohs(addr.sin_port),
-    };
+    switch (option) {
+    case tss::option_t::ReuseAddr:
+      return native_option{SOL_SOCKET, SO_REUSEADDR};
+#if defined(SO_REUSEPORT)
+    case tss::option_t::ReusePort:
+      return native_option{SOL_SOCKET, SO_REUSEPORT};
+#endif
+    case tss::option_t::SendBufferSize:
+      return native_option{SOL_SOCKET, SO_SNDBUF};
+    case tss::option_t::ReceiveBufferSize:
+      return native_option{SOL_SOCKET, SO_RCVBUF};
+#if defined(SO_PRIORITY)
+    case tss::option_t::Priority:
+      return native_option{SOL_SOCKET, SO_PRIORITY};
+#endif
+    case tss::option_t::KeepAlive:
+      return native_option{SOL_SOCKET, SO_KEEPALIVE};
+    case tss::option_t::TcpNoDelay:
+      return native_option{IPPROTO_TCP, TCP_NODELAY};
+#if defined(TCP_CORK)
+    case tss::option_t::TcpCork:
+      return native_option{IPPROTO_TCP, TCP_CORK};
+#endif
+#if defined(TCP_QUICKACK)
+    case tss::option_t::TcpQuickAck:
+      return native_option{IPPROTO_TCP, TCP_QUICKACK};
+#endif
+#if defined(TCP_FASTOPEN)
+    case tss::option_t::TcpFastOpen:
+      return native_option{IPPROTO_TCP, TCP_FASTOPEN};
+#endif
+#if defined(TCP_NOTSENT_LOWAT)
+    case tss::option_t::TcpNotSentLowAt:
+      return native_option{IPPROTO_TCP, TCP_NOTSENT_LOWAT};
+#endif
+#if defined(__linux__)
+    case tss::option_t::UdpSegment:
+      return native_option{IPPROTO_UDP, UDP_SEGMENT};
+    case tss::option_t::UdpGro:
+      return native_option{IPPROTO_UDP, UDP_GRO};
+#endif
+    case tss::option_t::IpTos:
+      return native_option{IPPROTO_IP, IP_TOS};
+    case tss::option_t::Ipv6V6Only:
+      return native_option{IPPROTO_IPV6, IPV6_V6ONLY};
+    default:
+      return std::nullopt;
+    }
   }
 }
 
@@ -150,7 +151,7 @@ namespace tss {
   namespace detail {
     template<ip_version_t TIP, protocol_t TProto>
     socket_base<TIP, TProto>::socket_base(native::socket_api const&)
-        : handle_{::socket(::af<TIP>, ::type<TProto>, ::proto<TProto>)}
+        : handle_{::socket(af<TIP>, type<TProto>, proto<TProto>)}
     {
       if (handle_==traits::invalid_value) {
         throw socket_error{};
@@ -159,7 +160,7 @@ namespace tss {
 
     template<ip_version_t TIP, protocol_t TProto>
     socket_base<TIP, TProto>::socket_base(socket_base&& src) noexcept
-        : handle_{src.handle_}
+        : handle_{src.handle_}, stats_{std::move(src.stats_)}
     {
       src.handle_ = traits::invalid_value;
     }
@@ -234,6 +235,271 @@ namespace tss {
       return !!reuse;
     }
 
+    template<ip_version_t TIP, protocol_t TProto>
+    void socket_base<TIP, TProto>::set_reuse_port(bool const reuse)
+    {
+#if defined(SO_REUSEPORT)
+      int value{reuse ? 1 : 0};
+      auto const result = ::setsockopt(handle_, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<traits::send_buf_t>(&value),
+          static_cast<traits::socklen_t>(sizeof(value)));
+      if (result==-1) {
+        throw socket_error{};
+      }
+#else
+      (void) reuse;
+      throw socket_error{error_code::not_supported().value()};
+#endif
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    bool socket_base<TIP, TProto>::get_reuse_port() const
+    {
+#if defined(SO_REUSEPORT)
+      int reuse{};
+      auto len{static_cast<traits::socklen_t>(sizeof(reuse))};
+      auto const result = ::getsockopt(handle_, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<traits::recv_buf_t>(&reuse),
+          &len);
+      if (result==-1) {
+        throw socket_error{};
+      }
+      return !!reuse;
+#else
+      throw socket_error{error_code::not_supported().value()};
+#endif
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    void socket_base<TIP, TProto>::set_non_blocking(bool const non_blocking)
+    {
+#if defined(_WIN32)
+      u_long mode{non_blocking ? 1UL : 0UL};
+      if (::ioctlsocket(handle_, FIONBIO, &mode)==SOCKET_ERROR) {
+        throw socket_error{};
+      }
+#else
+      auto const flags = ::fcntl(handle_, F_GETFL);
+      if (flags==-1) {
+        throw socket_error{};
+      }
+      auto const new_flags = non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+      if (new_flags!=flags && ::fcntl(handle_, F_SETFL, new_flags)==-1) {
+        throw socket_error{};
+      }
+#endif
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    void socket_base<TIP, TProto>::set_option_(option_t const option, int value)
+    {
+      auto const native = ::to_native(option);
+      if (!native) {
+        throw socket_error{error_code::not_supported().value()};
+      }
+      auto const result = ::setsockopt(handle_, native->level, native->name,
+          reinterpret_cast<traits::send_buf_t>(&value), static_cast<traits::socklen_t>(sizeof(value)));
+      if (result==-1) {
+        throw socket_error{};
+      }
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    int socket_base<TIP, TProto>::get_option_(option_t const option) const
+    {
+      auto const native = ::to_native(option);
+      if (!native) {
+        throw socket_error{error_code::not_supported().value()};
+      }
+      int value{};
+      auto len{static_cast<traits::socklen_t>(sizeof(value))};
+      auto const result = ::getsockopt(handle_, native->level, native->name,
+          reinterpret_cast<traits::recv_buf_t>(&value), &len);
+      if (result==-1) {
+        throw socket_error{};
+      }
+      return value;
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    io_stats socket_base<TIP, TProto>::stats() const noexcept
+    {
+      return stats_policy::snapshot(stats_);
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    void socket_base<TIP, TProto>::set_timestamping(timestamping_t const flags)
+    {
+#if defined(__linux__)
+      static std::array<std::pair<timestamping_t, unsigned int>, 6U> constexpr native_flags{{
+          {timestamping_t::RxSoftware, SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE},
+          {timestamping_t::RxHardware, SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE},
+          {timestamping_t::TxScheduled, SOF_TIMESTAMPING_TX_SCHED | SOF_TIMESTAMPING_SOFTWARE},
+          {timestamping_t::TxSoftware, SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE},
+          {timestamping_t::TxHardware, SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE},
+          {timestamping_t::TxAcknowledged, SOF_TIMESTAMPING_TX_ACK | SOF_TIMESTAMPING_SOFTWARE},
+      }};
+
+      unsigned int value{0U};
+      for (auto const& [flag, native]: native_flags) {
+        if ((flags & flag)!=timestamping_t::None) {
+          value |= native;
+        }
+      }
+      // identify the send of every report and do not loop the sent data back along with it
+      if ((value & SOF_TIMESTAMPING_TX_RECORD_MASK)!=0U) {
+        value |= SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+      }
+
+      if (::setsockopt(handle_, SOL_SOCKET, SO_TIMESTAMPING, &value, sizeof(value))==-1) {
+        throw socket_error{};
+      }
+#else
+      (void) flags;
+      throw socket_error{error_code::not_supported().value()};
+#endif
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    std::size_t socket_base<TIP, TProto>::receive_tx_timestamps(gsl::span<tx_timestamp> const reports)
+    {
+      return receive_tx_timestamps(std::nothrow, reports).value();
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    result<std::size_t>
+    socket_base<TIP, TProto>::receive_tx_timestamps(std::nothrow_t, gsl::span<tx_timestamp> const reports) noexcept
+    {
+#if defined(__linux__)
+      std::size_t count{0U};
+      while (count<reports.size()) {
+        alignas(cmsghdr) std::array<char,
+            CMSG_SPACE(sizeof(scm_timestamping))+CMSG_SPACE(sizeof(sock_extended_err)+sizeof(sockaddr_in6))> control{};
+        msghdr message{};
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+
+        if (::recvmsg(handle_, &message, MSG_ERRQUEUE | MSG_DONTWAIT)==-1) {
+          auto const error = error_code::last();
+          if (error==error_code::interrupted()) {
+            continue;
+          }
+          if (count>0U || error.would_block()) {
+            break;
+          }
+          return error;
+        }
+
+        for (auto* header = CMSG_FIRSTHDR(&message); header!=nullptr; header = CMSG_NXTHDR(&message, header)) {
+          auto const is_error = (header->cmsg_level==SOL_IP && header->cmsg_type==IP_RECVERR) ||
+              (header->cmsg_level==SOL_IPV6 && header->cmsg_type==IPV6_RECVERR);
+          if (!is_error) {
+            continue;
+          }
+
+          sock_extended_err error{};
+          std::memcpy(&error, CMSG_DATA(header), sizeof(error));
+          if (error.ee_errno!=ENOMSG || error.ee_origin!=SO_EE_ORIGIN_TIMESTAMPING) {
+            continue;
+          }
+
+          auto stage{tx_stage_t::Sent};
+          if (error.ee_info==SCM_TSTAMP_SCHED) {
+            stage = tx_stage_t::Scheduled;
+          }
+          else if (error.ee_info==SCM_TSTAMP_ACK) {
+            stage = tx_stage_t::Acknowledged;
+          }
+          reports[count++] = tx_timestamp{error.ee_data, stage, ::find_timestamps(message)};
+          break;
+        }
+      }
+      return count;
+#else
+      (void) reports;
+      return std::size_t{0U};
+#endif
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    result<timestamped_receive> socket_base<TIP, TProto>::receive_timestamped_(
+        address_t<TIP>* const address,
+        std::byte* const buffer,
+        std::size_t const buffer_length
+    ) noexcept
+    {
+      sockaddr_t<TIP> addr{};
+#if defined(__linux__)
+      iovec payload{buffer, buffer_length};
+      alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(scm_timestamping))+CMSG_SPACE(sizeof(int))> control{};
+
+      msghdr message{};
+      message.msg_name = &addr;
+      message.msg_namelen = sizeof(addr);
+      message.msg_iov = &payload;
+      message.msg_iovlen = 1U;
+      message.msg_control = control.data();
+      message.msg_controllen = control.size();
+
+      auto const result = ::recvmsg(handle_, &message, 0);
+      if (result==-1) {
+        return error_code::last();
+      }
+      timestamped_receive received{static_cast<std::size_t>(result), ::find_timestamps(message)};
+#else
+      auto addr_len{static_cast<traits::socklen_t>(sizeof(addr))};
+      auto const result = ::recvfrom(
+          handle_,
+          reinterpret_cast<traits::recv_buf_t>(buffer),
+          static_cast<traits::buflen_t>(buffer_length),
+          0,
+          reinterpret_cast<sockaddr*>(&addr),
+          &addr_len);
+      if (result==-1) {
+        return error_code::last();
+      }
+      timestamped_receive received{static_cast<std::size_t>(result), {}};
+#endif
+      if (address!=nullptr) {
+        *address = make_address(addr);
+      }
+      return received;
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    result<std::size_t>
+    socket_base<TIP, TProto>::send_(std::byte const* const data, std::size_t const data_length) noexcept
+    {
+      auto const started = stats_policy::start();
+      auto const result = ::send(
+          handle_,
+          reinterpret_cast<traits::send_buf_t>(data),
+          static_cast<traits::buflen_t>(data_length),
+          0
+      );
+      stats_policy::record(stats_, io_operation_t::Send, started, data_length, result);
+      if (result==-1) {
+        return error_code::last();
+      }
+      return static_cast<std::size_t>(result);
+    }
+
+    template<ip_version_t TIP, protocol_t TProto>
+    result<std::size_t>
+    socket_base<TIP, TProto>::receive_(std::byte* const buffer, std::size_t const buffer_length) noexcept
+    {
+      auto const started = stats_policy::start();
+      auto const result = ::recv(
+          handle_,
+          reinterpret_cast<traits::recv_buf_t>(buffer),
+          static_cast<traits::buflen_t>(buffer_length),
+          0
+      );
+      stats_policy::record(stats_, io_operation_t::Receive, started, buffer_length, result);
+      if (result==-1) {
+        return error_code::last();
+      }
+      return static_cast<std::size_t>(result);
+    }
+
     template<ip_version_t TIP, protocol_t TProto>
     socket_base<TIP, TProto>::socket_base(traits::socket_t const handle) noexcept
         : handle_{handle}
@@ -265,33 +531,108 @@ namespace tss {
   template<ip_version_t TIP>
   void socket<TIP, protocol_t::TCP>::connect(tss::address_t<TIP> const& address)
   {
-    auto const addr = make_sock_addr(address);
+    connect(std::nothrow, address).value();
+  }
+
+  template<ip_version_t TIP>
+  result<void> socket<TIP, protocol_t::TCP>::connect(std::nothrow_t, tss::address_t<TIP> const& address) noexcept
+  {
+    auto const addr = detail::make_sock_addr(address);
     auto const result = ::connect(
         handle_,
         reinterpret_cast<sockaddr const*>(&addr),
         static_cast<traits::socklen_t>(sizeof(addr))
     );
     if (result==-1) {
-      throw socket_error{};
+      return error_code::last();
     }
+    return {};
   }
 
   template<ip_version_t TIP>
   socket<TIP, protocol_t::TCP> socket<TIP, protocol_t::TCP>::accept(address_t<TIP>* address)
   {
-    ::sockaddr_t<TIP> addr{};
+    return accept(std::nothrow, address).value();
+  }
+
+  template<ip_version_t TIP>
+  result<socket<TIP, protocol_t::TCP>>
+  socket<TIP, protocol_t::TCP>::accept(std::nothrow_t, address_t<TIP>* address) noexcept
+  {
+    detail::sockaddr_t<TIP> addr{};
     auto addr_len{static_cast<traits::socklen_t>(sizeof(addr))};
+    auto const started = detail::stats_policy::start();
     auto const result = ::accept(
         handle_,
         reinterpret_cast<sockaddr*>(&addr),
         &addr_len
     );
+    detail::stats_policy::record(stats_, io_operation_t::Accept, started, 0U, result==traits::invalid_value ? -1 : 0);
     if (result==traits::invalid_value) {
-      throw socket_error{};
+      return error_code::last();
+    }
+    if (address!=nullptr) {
+      *address = detail::make_address(addr);
     }
     return socket{result};
   }
 
+  template<ip_version_t TIP>
+  std::size_t socket<TIP, protocol_t::TCP>::accept_many(
+      std::size_t const max,
+      std::vector<socket>& sockets,
+      std::vector<address_t<TIP>>* const addresses
+  )
+  {
+    std::size_t accepted{0U};
+    while (accepted<max) {
+      detail::sockaddr_t<TIP> addr{};
+      auto addr_len{static_cast<traits::socklen_t>(sizeof(addr))};
+      auto const started = detail::stats_policy::start();
+#if defined(__linux__)
+      auto const result = ::accept4(
+          handle_,
+          reinterpret_cast<sockaddr*>(&addr),
+          &addr_len,
+          SOCK_NONBLOCK | SOCK_CLOEXEC
+      );
+#else
+      auto const result = ::accept(
+          handle_,
+          reinterpret_cast<sockaddr*>(&addr),
+          &addr_len
+      );
+#endif
+      detail::stats_policy::record(stats_, io_operation_t::Accept, started, 0U, result==traits::invalid_value ? -1 : 0);
+      if (result==traits::invalid_value) {
+        auto const error = error_code::last();
+        if (error==error_code::interrupted() || error.connection_aborted()) {
+          continue;
+        }
+        if (accepted>0U || error.would_block()) {
+          break;
+        }
+        throw socket_error{error.value()};
+      }
+
+      socket sock{result};
+#if !defined(__linux__)
+      sock.set_non_blocking();
+#if !defined(_WIN32)
+      if (::fcntl(result, F_SETFD, FD_CLOEXEC)==-1) {
+        throw socket_error{};
+      }
+#endif
+#endif
+      if (addresses!=nullptr) {
+        addresses->push_back(detail::make_address(addr));
+      }
+      sockets.push_back(std::move(sock));
+      ++accepted;
+    }
+    return accepted;
+  }
+
   template<ip_version_t TIP>
   void socket<TIP, protocol_t::TCP>::shutdown(shutdown_t const how)
   {
@@ -333,61 +674,266 @@ namespace tss {
   }
 
   template<ip_version_t TIP>
-  std::size_t socket<TIP, protocol_t::TCP>::send_(std::byte const* const data, std::size_t const data_length)
+  void socket<TIP, protocol_t::TCP>::send_all_(std::byte const* data, std::size_t data_length)
   {
-    auto const result = ::send(
-        handle_,
-        reinterpret_cast<traits::send_buf_t>(data),
-        static_cast<traits::buflen_t>(data_length),
-        0
-    );
-    if (result==-1) {
+    while (data_length>0U) {
+      auto const sent = send_(data, data_length);
+      if (!sent && sent.error()==error_code::interrupted()) {
+        continue;
+      }
+      data += sent.value();
+      data_length -= *sent;
+    }
+  }
+
+  template<ip_version_t TIP>
+  std::size_t socket<TIP, protocol_t::TCP>::receive_exact_(std::byte* const buffer, std::size_t const buffer_length)
+  {
+    std::size_t received{0U};
+    while (received<buffer_length) {
+      // MSG_WAITALL lets the kernel do the looping, so usually a single call suffices
+      auto const result = ::recv(
+          handle_,
+          reinterpret_cast<traits::recv_buf_t>(buffer+received),
+          static_cast<traits::buflen_t>(buffer_length-received),
+          MSG_WAITALL
+      );
+      if (result==-1) {
+        if (auto const error = error_code::last(); error!=error_code::interrupted()) {
+          throw socket_error{error.value()};
+        }
+        continue;
+      }
+      if (result==0) {
+        break;
+      }
+      received += static_cast<std::size_t>(result);
+    }
+    return received;
+  }
+
+  template<ip_version_t TIP>
+  pooled_buffer socket<TIP, protocol_t::TCP>::receive(buffer_pool& pool)
+  {
+    return receive(std::nothrow, pool).value();
+  }
+
+  template<ip_version_t TIP>
+  result<pooled_buffer> socket<TIP, protocol_t::TCP>::receive(std::nothrow_t, buffer_pool& pool) noexcept
+  {
+    auto buffer = pool.acquire(std::nothrow);
+    if (!buffer) {
+      return buffer.error();
+    }
+
+    auto const received = receive_(buffer->data().data(), buffer->capacity());
+    if (!received) {
+      return received.error();
+    }
+    if (*received==0U) {
+      return pooled_buffer{};
+    }
+    buffer->resize(*received);
+    return std::move(*buffer);
+  }
+
+  template<ip_version_t TIP>
+  std::size_t
+  socket<TIP, protocol_t::TCP>::send_file(int const file, std::uint64_t const offset, std::size_t const length)
+  {
+    return send_file(std::nothrow, file, offset, length).value();
+  }
+
+  template<ip_version_t TIP>
+  result<std::size_t> socket<TIP, protocol_t::TCP>::send_file(
+      std::nothrow_t,
+      int const file,
+      std::uint64_t const offset,
+      std::size_t const length
+  ) noexcept
+  {
+#if defined(_WIN32)
+    (void) file;
+    (void) offset;
+    (void) length;
+    return error_code::not_supported();
+#else
+    std::size_t sent{0U};
+    while (sent<length) {
+#if defined(__linux__)
+      // the kernel never transfers more than this per call anyway
+      std::size_t constexpr max_chunk{0x7ffff000U};
+      auto position{static_cast<off_t>(offset+sent)};
+      auto const result = ::sendfile(handle_, file, &position, std::min(length-sent, max_chunk));
+#else
+      std::array<std::byte, 64U*1024U> chunk{};
+      auto const read = ::pread(file, chunk.data(), std::min(length-sent, chunk.size()),
+          static_cast<off_t>(offset+sent));
+      if (read==-1) {
+        return error_code::last();
+      }
+      auto const result = read==0 ? ssize_t{0} : ::send(handle_, chunk.data(), static_cast<std::size_t>(read), 0);
+#endif
+      if (result==-1) {
+        auto const error = error_code::last();
+        if (error==error_code::interrupted()) {
+          continue;
+        }
+        if (sent>0U && error.would_block()) {
+          break;
+        }
+        return error;
+      }
+      if (result==0) {
+        break;
+      }
+      sent += static_cast<std::size_t>(result);
+    }
+    return sent;
+#endif
+  }
+
+  template<ip_version_t TIP>
+  std::size_t socket<TIP, protocol_t::TCP>::send_file(
+      std::filesystem::path const& path,
+      std::uint64_t const offset,
+      std::size_t const length
+  )
+  {
+#if defined(_WIN32)
+    (void) path;
+    (void) offset;
+    (void) length;
+    throw socket_error{error_code::not_supported().value()};
+#else
+    auto const file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file==-1) {
       throw socket_error{};
     }
-    return static_cast<std::size_t>(result);
+    auto const sent = send_file(std::nothrow, file, offset, length);
+    ::close(file);
+    return sent.value();
+#endif
   }
 
   template<ip_version_t TIP>
-  std::size_t socket<TIP, protocol_t::TCP>::receive_(std::byte* const buffer, std::size_t const buffer_length)
+  vectored_progress socket<TIP, protocol_t::TCP>::send_vectored(gsl::span<const_buffer const> const buffers)
   {
-    auto const result = ::recv(
-        handle_,
-        reinterpret_cast<traits::recv_buf_t>(buffer),
-        static_cast<traits::buflen_t>(buffer_length),
-        0
+    return send_vectored(std::nothrow, buffers).value();
+  }
+
+  template<ip_version_t TIP>
+  result<vectored_progress>
+  socket<TIP, protocol_t::TCP>::send_vectored(std::nothrow_t, gsl::span<const_buffer const> const buffers) noexcept
+  {
+    auto const count = std::min(buffers.size(), max_vectored_buffers);
+    auto const used = buffers.first(count);
+#if defined(_WIN32)
+    std::array<WSABUF, max_vectored_buffers> native_buffers{};
+    for (std::size_t i = 0U; i<count; ++i) {
+      native_buffers[i].len = static_cast<ULONG>(used[i].size());
+      native_buffers[i].buf = const_cast<CHAR*>(reinterpret_cast<CHAR const*>(used[i].data()));
+    }
+
+    DWORD sent{};
+    auto const result = ::WSASend(handle_, native_buffers.data(), static_cast<DWORD>(count), &sent, 0, nullptr, nullptr);
+    if (result==SOCKET_ERROR) {
+      return error_code::last();
+    }
+    return ::make_progress(used, static_cast<std::size_t>(sent));
+#else
+    std::array<iovec, max_vectored_buffers> native_buffers{};
+    for (std::size_t i = 0U; i<count; ++i) {
+      native_buffers[i].iov_base = const_cast<std::byte*>(used[i].data());
+      native_buffers[i].iov_len = used[i].size();
+    }
+
+    msghdr message{};
+    message.msg_iov = native_buffers.data();
+    message.msg_iovlen = count;
+    auto const result = ::sendmsg(handle_, &message, 0);
+    if (result==-1) {
+      return error_code::last();
+    }
+    return ::make_progress(used, static_cast<std::size_t>(result));
+#endif
+  }
+
+  template<ip_version_t TIP>
+  vectored_progress socket<TIP, protocol_t::TCP>::receive_vectored(gsl::span<mutable_buffer const> const buffers)
+  {
+    return receive_vectored(std::nothrow, buffers).value();
+  }
+
+  template<ip_version_t TIP>
+  result<vectored_progress>
+  socket<TIP, protocol_t::TCP>::receive_vectored(std::nothrow_t, gsl::span<mutable_buffer const> const buffers) noexcept
+  {
+    auto const count = std::min(buffers.size(), max_vectored_buffers);
+    auto const used = buffers.first(count);
+#if defined(_WIN32)
+    std::array<WSABUF, max_vectored_buffers> native_buffers{};
+    for (std::size_t i = 0U; i<count; ++i) {
+      native_buffers[i].len = static_cast<ULONG>(used[i].size());
+      native_buffers[i].buf = reinterpret_cast<CHAR*>(used[i].data());
+    }
+
+    DWORD received{};
+    DWORD flags{};
+    auto const result = ::WSARecv(
+        handle_, native_buffers.data(), static_cast<DWORD>(count), &received, &flags, nullptr, nullptr
     );
+    if (result==SOCKET_ERROR) {
+      return error_code::last();
+    }
+    return ::make_progress(used, static_cast<std::size_t>(received));
+#else
+    std::array<iovec, max_vectored_buffers> native_buffers{};
+    for (std::size_t i = 0U; i<count; ++i) {
+      native_buffers[i].iov_base = used[i].data();
+      native_buffers[i].iov_len = used[i].size();
+    }
+
+    msghdr message{};
+    message.msg_iov = native_buffers.data();
+    message.msg_iovlen = count;
+    auto const result = ::recvmsg(handle_, &message, 0);
     if (result==-1) {
-      throw socket_error{};
+      return error_code::last();
     }
-    return static_cast<std::size_t>(result);
+    return ::make_progress(used, static_cast<std::size_t>(result));
+#endif
   }
 
   template<ip_version_t TIP>
-  std::size_t socket<TIP, protocol_t::UDP>::send_to_(
+  result<std::size_t> socket<TIP, protocol_t::UDP>::send_to_(
       address_t<TIP> const& address,
       std::byte const* const data,
       std::size_t const data_length
-  )
+  ) noexcept
   {
-    auto const addr = make_sock_addr(address);
+    auto const addr = detail::make_sock_addr(address);
+    auto const started = detail::stats_policy::start();
     auto const result = ::sendto(handle_, reinterpret_cast<traits::send_buf_t>(data),
         static_cast<traits::buflen_t>(data_length), 0, reinterpret_cast<sockaddr const*>(&addr),
         static_cast<traits::socklen_t>(sizeof(addr)));
+    detail::stats_policy::record(stats_, io_operation_t::SendTo, started, data_length, result);
     if (result==-1) {
-      throw socket_error{};
+      return error_code::last();
     }
     return static_cast<std::size_t>(result);
   }
 
   template<ip_version_t TIP>
-  std::size_t socket<TIP, protocol_t::UDP>::receive_from_(
+  result<std::size_t> socket<TIP, protocol_t::UDP>::receive_from_(
       address_t<TIP>* const address,
       std::byte* const buffer,
       std::size_t const buffer_length
-  )
+  ) noexcept
   {
-    ::sockaddr_t<TIP> addr{};
+    detail::sockaddr_t<TIP> addr{};
     auto addr_len{static_cast<traits::socklen_t>(sizeof(addr))};
+    auto const started = detail::stats_policy::start();
     auto const result = ::recvfrom(
         handle_,
         reinterpret_cast<traits::recv_buf_t>(buffer),
@@ -395,16 +941,361 @@ namespace tss {
         0,
         reinterpret_cast<sockaddr*>(&addr),
         &addr_len);
+    detail::stats_policy::record(stats_, io_operation_t::ReceiveFrom, started, buffer_length, result);
+
+    if (result==-1) {
+      return error_code::last();
+    }
 
     if (address!=nullptr) {
-      *address = make_address(addr);
+      *address = detail::make_address(addr);
+    }
+
+    return static_cast<std::size_t>(result);
+  }
+
+  template<ip_version_t TIP>
+  pooled_buffer socket<TIP, protocol_t::UDP>::receive_from(address_t<TIP>* const address, buffer_pool& pool)
+  {
+    return receive_from(std::nothrow, address, pool).value();
+  }
+
+  template<ip_version_t TIP>
+  result<pooled_buffer>
+  socket<TIP, protocol_t::UDP>::receive_from(std::nothrow_t, address_t<TIP>* const address, buffer_pool& pool) noexcept
+  {
+    auto buffer = pool.acquire(std::nothrow);
+    if (!buffer) {
+      return buffer.error();
+    }
+
+    auto const received = receive_from_(address, buffer->data().data(), buffer->capacity());
+    if (!received) {
+      return received.error();
+    }
+    buffer->resize(*received);
+    return std::move(*buffer);
+  }
+
+  template<ip_version_t TIP>
+  std::size_t socket<TIP, protocol_t::UDP>::send_batch(gsl::span<outgoing_datagram<TIP> const> const datagrams)
+  {
+    return send_batch(std::nothrow, datagrams).value();
+  }
+
+  template<ip_version_t TIP>
+  result<std::size_t> socket<TIP, protocol_t::UDP>::send_batch(
+      std::nothrow_t,
+      gsl::span<outgoing_datagram<TIP> const> const datagrams
+  ) noexcept
+  {
+    Expects(!datagrams.empty());
+    auto const count = std::min(datagrams.size(), max_batched_datagrams);
+#if defined(__linux__)
+    std::array<mmsghdr, max_batched_datagrams> messages{};
+    std::array<iovec, max_batched_datagrams> payloads{};
+    std::array<detail::sockaddr_t<TIP>, max_batched_datagrams> addresses{};
+    for (std::size_t i = 0U; i<count; ++i) {
+      auto const& datagram = datagrams[i];
+      addresses[i] = detail::make_sock_addr(datagram.address);
+      payloads[i].iov_base = const_cast<std::byte*>(datagram.buffer.data());
+      payloads[i].iov_len = datagram.buffer.size();
+      messages[i].msg_hdr.msg_name = &addresses[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+      messages[i].msg_hdr.msg_iov = &payloads[i];
+      messages[i].msg_hdr.msg_iovlen = 1U;
+    }
+
+    auto const result = ::sendmmsg(handle_, messages.data(), static_cast<unsigned int>(count), 0);
+    if (result==-1) {
+      return error_code::last();
+    }
+    return static_cast<std::size_t>(result);
+#else
+    // without sendmmsg, report the datagrams sent until the first failure
+    for (std::size_t i = 0U; i<count; ++i) {
+      auto const& datagram = datagrams[i];
+      if (auto const sent = send_to_(datagram.address, datagram.buffer.data(), datagram.buffer.size()); !sent) {
+        if (i==0U) {
+          return sent.error();
+        }
+        return i;
+      }
+    }
+    return count;
+#endif
+  }
+
+  template<ip_version_t TIP>
+  std::size_t socket<TIP, protocol_t::UDP>::receive_batch(gsl::span<incoming_datagram<TIP>> const datagrams)
+  {
+    return receive_batch(std::nothrow, datagrams).value();
+  }
+
+  template<ip_version_t TIP>
+  result<std::size_t> socket<TIP, protocol_t::UDP>::receive_batch(
+      std::nothrow_t,
+      gsl::span<incoming_datagram<TIP>> const datagrams
+  ) noexcept
+  {
+    Expects(!datagrams.empty());
+#if defined(__linux__)
+    auto const count = std::min(datagrams.size(), max_batched_datagrams);
+    std::array<mmsghdr, max_batched_datagrams> messages{};
+    std::array<iovec, max_batched_datagrams> payloads{};
+    std::array<detail::sockaddr_t<TIP>, max_batched_datagrams> addresses{};
+    for (std::size_t i = 0U; i<count; ++i) {
+      payloads[i].iov_base = datagrams[i].buffer.data();
+      payloads[i].iov_len = datagrams[i].buffer.size();
+      messages[i].msg_hdr.msg_name = &addresses[i];
+      messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+      messages[i].msg_hdr.msg_iov = &payloads[i];
+      messages[i].msg_hdr.msg_iovlen = 1U;
+    }
+
+    auto const result = ::recvmmsg(handle_, messages.data(), static_cast<unsigned int>(count), MSG_WAITFORONE, nullptr);
+    if (result==-1) {
+      return error_code::last();
+    }
+
+    auto const received = static_cast<std::size_t>(result);
+    for (std::size_t i = 0U; i<received; ++i) {
+      datagrams[i].length = messages[i].msg_len;
+      datagrams[i].address = detail::make_address(addresses[i]);
+    }
+    return received;
+#else
+    // without recvmmsg, a second receive could block, so only a single datagram is taken
+    auto& datagram = datagrams[0U];
+    auto const received = receive_from_(&datagram.address, datagram.buffer.data(), datagram.buffer.size());
+    if (!received) {
+      return received.error();
+    }
+    datagram.length = *received;
+    return std::size_t{1U};
+#endif
+  }
+
+  template<ip_version_t TIP>
+  std::size_t socket<TIP, protocol_t::UDP>::receive_batch(
+      buffer_pool& pool,
+      gsl::span<pooled_datagram<TIP>> const datagrams
+  )
+  {
+    return receive_batch(std::nothrow, pool, datagrams).value();
+  }
+
+  template<ip_version_t TIP>
+  result<std::size_t> socket<TIP, protocol_t::UDP>::receive_batch(
+      std::nothrow_t,
+      buffer_pool& pool,
+      gsl::span<pooled_datagram<TIP>> const datagrams
+  ) noexcept
+  {
+    Expects(!datagrams.empty());
+    auto const slots = std::min(datagrams.size(), max_batched_datagrams);
+    std::array<incoming_datagram<TIP>, max_batched_datagrams> incoming{};
+    std::size_t count{0U};
+    for (; count<slots; ++count) {
+      auto buffer = pool.acquire(std::nothrow);
+      if (!buffer) {
+        // a smaller batch is better than none
+        if (count==0U) {
+          return buffer.error();
+        }
+        break;
+      }
+      datagrams[count].buffer = std::move(*buffer);
+      incoming[count].buffer = datagrams[count].buffer.data();
+    }
+
+    auto const received = receive_batch(std::nothrow, gsl::span<incoming_datagram<TIP>>{incoming}.first(count));
+    auto const filled = received ? *received : 0U;
+    for (std::size_t i = 0U; i<count; ++i) {
+      if (i<filled) {
+        datagrams[i].buffer.resize(incoming[i].length);
+        datagrams[i].address = incoming[i].address;
+      }
+      else {
+        datagrams[i].buffer.reset();
+      }
     }
+    return received;
+  }
 
+  template<ip_version_t TIP>
+  connected_udp_socket<TIP> socket<TIP, protocol_t::UDP>::connect(address_t<TIP> const& address) &&
+  {
+    auto const addr = detail::make_sock_addr(address);
+    auto const result = ::connect(handle_, reinterpret_cast<sockaddr const*>(&addr), traits::socklen_t{sizeof(addr)});
     if (result==-1) {
       throw socket_error{};
     }
+    return connected_udp_socket<TIP>{std::move(*this)};
+  }
+
+  template<ip_version_t TIP>
+  void socket<TIP, protocol_t::UDP>::set_segment_size(std::uint16_t const segment_size)
+  {
+#if defined(__linux__)
+    int value{segment_size};
+    if (::setsockopt(handle_, IPPROTO_UDP, UDP_SEGMENT, &value, sizeof(value))==-1) {
+      throw socket_error{};
+    }
+#else
+    (void) segment_size;
+    throw socket_error{error_code::not_supported().value()};
+#endif
+  }
+
+  template<ip_version_t TIP>
+  std::uint16_t socket<TIP, protocol_t::UDP>::get_segment_size() const
+  {
+#if defined(__linux__)
+    int value{};
+    auto len{static_cast<socklen_t>(sizeof(value))};
+    if (::getsockopt(handle_, IPPROTO_UDP, UDP_SEGMENT, &value, &len)==-1) {
+      throw socket_error{};
+    }
+    return static_cast<std::uint16_t>(value);
+#else
+    throw socket_error{error_code::not_supported().value()};
+#endif
+  }
 
+  template<ip_version_t TIP>
+  void socket<TIP, protocol_t::UDP>::set_receive_offload(bool const enable)
+  {
+#if defined(__linux__)
+    int value{enable ? 1 : 0};
+    if (::setsockopt(handle_, IPPROTO_UDP, UDP_GRO, &value, sizeof(value))==-1) {
+      throw socket_error{};
+    }
+#else
+    (void) enable;
+    throw socket_error{error_code::not_supported().value()};
+#endif
+  }
+
+  template<ip_version_t TIP>
+  bool socket<TIP, protocol_t::UDP>::get_receive_offload() const
+  {
+#if defined(__linux__)
+    int value{};
+    auto len{static_cast<socklen_t>(sizeof(value))};
+    if (::getsockopt(handle_, IPPROTO_UDP, UDP_GRO, &value, &len)==-1) {
+      throw socket_error{};
+    }
+    return !!value;
+#else
+    throw socket_error{error_code::not_supported().value()};
+#endif
+  }
+
+  template<ip_version_t TIP>
+  std::size_t socket<TIP, protocol_t::UDP>::send_segmented(
+      address_t<TIP> const& address,
+      const_buffer const data,
+      std::uint16_t const segment_size
+  )
+  {
+    return send_segmented(std::nothrow, address, data, segment_size).value();
+  }
+
+  template<ip_version_t TIP>
+  result<std::size_t> socket<TIP, protocol_t::UDP>::send_segmented(
+      std::nothrow_t,
+      address_t<TIP> const& address,
+      const_buffer const data,
+      std::uint16_t const segment_size
+  ) noexcept
+  {
+#if defined(__linux__)
+    auto addr = detail::make_sock_addr(address);
+    iovec payload{const_cast<std::byte*>(data.data()), data.size()};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(std::uint16_t))> control{};
+
+    msghdr message{};
+    message.msg_name = &addr;
+    message.msg_namelen = sizeof(addr);
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1U;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    auto* const header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = IPPROTO_UDP;
+    header->cmsg_type = UDP_SEGMENT;
+    header->cmsg_len = CMSG_LEN(sizeof(segment_size));
+    std::memcpy(CMSG_DATA(header), &segment_size, sizeof(segment_size));
+
+    auto const result = ::sendmsg(handle_, &message, 0);
+    if (result==-1) {
+      return error_code::last();
+    }
     return static_cast<std::size_t>(result);
+#else
+    (void) address;
+    (void) data;
+    (void) segment_size;
+    return error_code::not_supported();
+#endif
+  }
+
+  template<ip_version_t TIP>
+  coalesced_datagram
+  socket<TIP, protocol_t::UDP>::receive_coalesced(address_t<TIP>* const address, mutable_buffer const buffer)
+  {
+    return receive_coalesced(std::nothrow, address, buffer).value();
+  }
+
+  template<ip_version_t TIP>
+  result<coalesced_datagram> socket<TIP, protocol_t::UDP>::receive_coalesced(
+      std::nothrow_t,
+      address_t<TIP>* const address,
+      mutable_buffer const buffer
+  ) noexcept
+  {
+#if defined(__linux__)
+    detail::sockaddr_t<TIP> addr{};
+    iovec payload{buffer.data(), buffer.size()};
+    alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(int))> control{};
+
+    msghdr message{};
+    message.msg_name = &addr;
+    message.msg_namelen = sizeof(addr);
+    message.msg_iov = &payload;
+    message.msg_iovlen = 1U;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    auto const result = ::recvmsg(handle_, &message, 0);
+    if (result==-1) {
+      return error_code::last();
+    }
+
+    // an empty datagram still reports a usable segment size, which segments requires
+    auto const length = static_cast<std::size_t>(result);
+    coalesced_datagram datagram{length, std::max(length, std::size_t{1U})};
+    for (auto* header = CMSG_FIRSTHDR(&message); header!=nullptr; header = CMSG_NXTHDR(&message, header)) {
+      if (header->cmsg_level==IPPROTO_UDP && header->cmsg_type==UDP_GRO) {
+        int segment_size{};
+        std::memcpy(&segment_size, CMSG_DATA(header), sizeof(segment_size));
+        datagram.segment_size = static_cast<std::size_t>(segment_size);
+      }
+    }
+
+    if (address!=nullptr) {
+      *address = detail::make_address(addr);
+    }
+    return datagram;
+#else
+    auto const received = receive_from_(address, buffer.data(), buffer.size());
+    if (!received) {
+      return received.error();
+    }
+    return coalesced_datagram{*received, std::max(*received, std::size_t{1U})};
+#endif
   }
 
   template
@@ -418,4 +1309,10 @@ namespace tss {
 
   template
   class socket<ip_version_t::V6, protocol_t::UDP>;
+
+  template
+  class connected_udp_socket<ip_version_t::V4>;
+
+  template
+  class connected_udp_socket<ip_version_t::V6>;
 }
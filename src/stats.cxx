@@ -0,0 +1,129 @@
+#include <tss/stats.hxx>
+#include <tss/exceptions.hxx>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+  std::size_t bucket_of(std::chrono::nanoseconds const latency) noexcept
+  {
+    auto const nanoseconds = static_cast<std::uint64_t>(std::max(latency.count(), std::int64_t{0}));
+    return std::min(static_cast<std::size_t>(std::bit_width(nanoseconds)), tss::latency_buckets-1U);
+  }
+
+  bool is_send(tss::io_operation_t const operation) noexcept
+  {
+    return operation==tss::io_operation_t::Send || operation==tss::io_operation_t::SendTo;
+  }
+}
+
+namespace tss {
+  std::uint64_t latency_histogram::count() const noexcept
+  {
+    std::uint64_t total{0U};
+    for (auto const bucket: buckets) {
+      total += bucket;
+    }
+    return total;
+  }
+
+  std::chrono::nanoseconds latency_histogram::percentile(double const fraction) const noexcept
+  {
+    auto const total = count();
+    if (total==0U) {
+      return std::chrono::nanoseconds{0};
+    }
+
+    auto const rank = static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0)*static_cast<double>(total)));
+    std::uint64_t seen{0U};
+    for (std::size_t i = 0U; i<buckets.size(); ++i) {
+      seen += buckets[i];
+      if (seen>=std::max(rank, std::uint64_t{1U})) {
+        if (i+1U==buckets.size()) {
+          break;
+        }
+        return std::chrono::nanoseconds{std::int64_t{1} << i};
+      }
+    }
+    return std::chrono::nanoseconds::max();
+  }
+
+  io_stats global_stats() noexcept
+  {
+    return detail::global_counters().snapshot();
+  }
+
+  namespace detail {
+    void io_counters::record(
+        io_operation_t const operation,
+        std::chrono::nanoseconds const latency,
+        std::size_t const requested,
+        std::ptrdiff_t const result,
+        bool const would_block
+    ) noexcept
+    {
+      auto& counters = operations_[static_cast<std::size_t>(operation)];
+      counters.calls.fetch_add(1U, std::memory_order_relaxed);
+      if (result>=0) {
+        counters.bytes.fetch_add(static_cast<std::uint64_t>(result), std::memory_order_relaxed);
+        if (::is_send(operation) && static_cast<std::size_t>(result)<requested) {
+          counters.partial.fetch_add(1U, std::memory_order_relaxed);
+        }
+      }
+      else if (would_block) {
+        counters.would_block.fetch_add(1U, std::memory_order_relaxed);
+      }
+      else {
+        counters.errors.fetch_add(1U, std::memory_order_relaxed);
+      }
+      counters.latency[::bucket_of(latency)].fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    io_stats io_counters::snapshot() const noexcept
+    {
+      io_stats stats{};
+      for (std::size_t i = 0U; i<operations_.size(); ++i) {
+        auto const& counters = operations_[i];
+        auto& target = stats.operations[i];
+        target.calls = counters.calls.load(std::memory_order_relaxed);
+        target.bytes = counters.bytes.load(std::memory_order_relaxed);
+        target.would_block = counters.would_block.load(std::memory_order_relaxed);
+        target.errors = counters.errors.load(std::memory_order_relaxed);
+        target.partial = counters.partial.load(std::memory_order_relaxed);
+        for (std::size_t bucket = 0U; bucket<latency_buckets; ++bucket) {
+          target.latency.buckets[bucket] = counters.latency[bucket].load(std::memory_order_relaxed);
+        }
+      }
+      return stats;
+    }
+
+    io_counters& global_counters() noexcept
+    {
+      static io_counters counters{};
+      return counters;
+    }
+
+    void counting_stats::record(
+        counters& target,
+        io_operation_t const operation,
+        time_point const started,
+        std::size_t const requested,
+        std::ptrdiff_t const result
+    ) noexcept
+    {
+      auto const latency = std::chrono::duration_cast<std::chrono::nanoseconds>(start()-started);
+      // reading the error code leaves it intact for the caller
+      auto const would_block = result<0 && error_code::last().would_block();
+      global_counters().record(operation, latency, requested, result, would_block);
+      if (target.values) {
+        target.values->record(operation, latency, requested, result, would_block);
+      }
+    }
+
+    io_stats counting_stats::snapshot(counters const& source) noexcept
+    {
+      return source.values ? source.values->snapshot() : io_stats{};
+    }
+  }
+}
@@ -0,0 +1,479 @@
+#include <tss/uring_engine.hxx>
+#include <tss/exceptions.hxx>
+
+#include "sockaddr.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+  int io_uring_setup(std::uint32_t const entries, io_uring_params* const params) noexcept
+  {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+  }
+
+  int io_uring_enter(int const ring_fd, std::uint32_t const to_submit, std::uint32_t const min_complete,
+      std::uint32_t const flags) noexcept
+  {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+  }
+
+  int io_uring_register(int const ring_fd, std::uint32_t const opcode, void const* const arg,
+      std::uint32_t const nr_args) noexcept
+  {
+    return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+  }
+
+  template<typename T>
+  T* offset_ptr(void* const base, std::uint32_t const offset) noexcept
+  {
+    return reinterpret_cast<T*>(static_cast<std::byte*>(base)+offset);
+  }
+
+  std::uint32_t load_acquire(std::uint32_t const* const value) noexcept
+  {
+    return std::atomic_ref{*const_cast<std::uint32_t*>(value)}.load(std::memory_order_acquire);
+  }
+
+  void store_release(std::uint32_t* const value, std::uint32_t const new_value) noexcept
+  {
+    std::atomic_ref{*value}.store(new_value, std::memory_order_release);
+  }
+
+  // lengths of submission queue entries are 32 bits wide, so larger buffers are transferred partially
+  std::uint32_t clamp_length(std::size_t const length) noexcept
+  {
+    return static_cast<std::uint32_t>(std::min<std::size_t>(length, std::numeric_limits<std::uint32_t>::max()));
+  }
+}
+
+namespace tss {
+  namespace detail {
+    /**
+     * State that has to outlive the submission of an operation, e.g. the address of a connect.
+     */
+    struct uring_operation final {
+      std::uint64_t user_data{};
+      sockaddr_in6 address{};
+      msghdr message{};
+      iovec vector{};
+    };
+
+    struct uring_data final {
+      int ring_fd{-1};
+
+      void* sq_ring{MAP_FAILED};
+      std::size_t sq_ring_size{};
+      void* cq_ring{MAP_FAILED};
+      std::size_t cq_ring_size{};
+      io_uring_sqe* sqes{static_cast<io_uring_sqe*>(MAP_FAILED)};
+      std::size_t sqes_size{};
+
+      std::uint32_t* sq_head{};
+      std::uint32_t* sq_tail{};
+      std::uint32_t* sq_array{};
+      std::uint32_t sq_mask{};
+      std::uint32_t sq_entries{};
+      std::uint32_t to_submit{};
+
+      std::uint32_t* cq_head{};
+      std::uint32_t* cq_tail{};
+      std::uint32_t cq_mask{};
+      io_uring_cqe* cqes{};
+
+      // a deque never moves its elements, so the kernel may keep pointing into them
+      std::deque<uring_operation> operations{};
+      std::vector<std::uint32_t> free_operations{};
+      std::vector<std::uint32_t> free_slots{};
+      std::vector<uring_engine::completion> completions{};
+
+      ~uring_data() noexcept
+      {
+        if (sqes!=MAP_FAILED) {
+          ::munmap(sqes, sqes_size);
+        }
+        if (cq_ring!=MAP_FAILED && cq_ring!=sq_ring) {
+          ::munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring!=MAP_FAILED) {
+          ::munmap(sq_ring, sq_ring_size);
+        }
+        if (ring_fd!=-1) {
+          ::close(ring_fd);
+        }
+      }
+
+      std::uint32_t acquire_operation(std::uint64_t const user_data)
+      {
+        std::uint32_t index{};
+        if (free_operations.empty()) {
+          index = static_cast<std::uint32_t>(operations.size());
+          operations.emplace_back();
+        }
+        else {
+          index = free_operations.back();
+          free_operations.pop_back();
+          operations[index] = {};
+        }
+        operations[index].user_data = user_data;
+        return index;
+      }
+
+      void flush()
+      {
+        while (to_submit>0U) {
+          auto const result = ::io_uring_enter(ring_fd, to_submit, 0U, 0U);
+          if (result==-1) {
+            if (errno==EINTR) {
+              continue;
+            }
+            throw socket_error{};
+          }
+          to_submit -= static_cast<std::uint32_t>(result);
+        }
+      }
+
+      io_uring_sqe& next_sqe(std::uint64_t const user_data)
+      {
+        if (*sq_tail-::load_acquire(sq_head)==sq_entries) {
+          flush();
+        }
+
+        auto const tail = *sq_tail;
+        auto const index = tail & sq_mask;
+        auto& sqe = sqes[index];
+        sqe = {};
+        sqe.user_data = acquire_operation(user_data);
+        sq_array[index] = index;
+        ::store_release(sq_tail, tail+1U);
+        ++to_submit;
+        return sqe;
+      }
+
+      io_uring_sqe& next_sqe(int const fd, bool const fixed, std::uint64_t const user_data)
+      {
+        auto& sqe = next_sqe(user_data);
+        sqe.fd = fd;
+        if (fixed) {
+          sqe.flags |= IOSQE_FIXED_FILE;
+        }
+        return sqe;
+      }
+
+      void reap()
+      {
+        completions.clear();
+
+        auto head = *cq_head;
+        auto const tail = ::load_acquire(cq_tail);
+        for (; head!=tail; ++head) {
+          auto const& cqe = cqes[head & cq_mask];
+          auto const index = static_cast<std::uint32_t>(cqe.user_data);
+          completions.push_back({operations[index].user_data, cqe.res, cqe.flags});
+          if ((cqe.flags & IORING_CQE_F_MORE)==0U) {
+            free_operations.push_back(index);
+          }
+        }
+        ::store_release(cq_head, head);
+      }
+
+      /**
+       * Cancel all operations in flight and wait for their completions, so the kernel no longer uses their buffers.
+       */
+      void cancel_all() noexcept
+      {
+        try {
+          flush();
+          while (operations.size()>free_operations.size()) {
+            // operations caught by a cancellation may complete after it, in which case the next round finds nothing
+            auto& sqe = next_sqe(0U);
+            sqe.opcode = IORING_OP_ASYNC_CANCEL;
+            sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY;
+            flush();
+
+            if (::io_uring_enter(ring_fd, 0U, 1U, IORING_ENTER_GETEVENTS)==-1 && errno!=EINTR) {
+              return;
+            }
+            reap();
+          }
+        }
+        catch (socket_error const&) {
+          // without a working ring there is nothing left to wait for
+        }
+      }
+
+      template<typename TAddress>
+      void send_to(int const fd, bool const fixed, TAddress const& address,
+          gsl::span<std::byte const> const buffer, std::uint64_t const user_data)
+      {
+        auto& sqe = next_sqe(fd, fixed, user_data);
+        auto& operation = operations[static_cast<std::size_t>(sqe.user_data)];
+
+        auto const addr = make_sock_addr(address);
+        std::memcpy(&operation.address, &addr, sizeof(addr));
+        operation.vector.iov_base = const_cast<std::byte*>(buffer.data());
+        operation.vector.iov_len = buffer.size();
+        operation.message.msg_name = &operation.address;
+        operation.message.msg_namelen = sizeof(addr);
+        operation.message.msg_iov = &operation.vector;
+        operation.message.msg_iovlen = 1U;
+
+        sqe.opcode = IORING_OP_SENDMSG;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(&operation.message);
+        sqe.len = 1U;
+        sqe.msg_flags = MSG_NOSIGNAL;
+      }
+
+      template<typename TAddress>
+      void connect(int const fd, bool const fixed, TAddress const& address, std::uint64_t const user_data)
+      {
+        auto& sqe = next_sqe(fd, fixed, user_data);
+        auto& operation = operations[static_cast<std::size_t>(sqe.user_data)];
+
+        auto const addr = make_sock_addr(address);
+        std::memcpy(&operation.address, &addr, sizeof(addr));
+
+        sqe.opcode = IORING_OP_CONNECT;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(&operation.address);
+        sqe.off = sizeof(addr);
+      }
+    };
+  }
+
+  bool uring_engine::completion::has_more() const noexcept
+  {
+    return (flags & IORING_CQE_F_MORE)!=0U;
+  }
+
+  std::optional<std::uint16_t> uring_engine::completion::buffer_id() const noexcept
+  {
+    if ((flags & IORING_CQE_F_BUFFER)==0U) {
+      return std::nullopt;
+    }
+    return static_cast<std::uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+  }
+
+  uring_engine::uring_engine(std::uint32_t const entries, std::uint32_t const registered_sockets,
+      native::socket_api const&)
+      :data_{std::make_unique<detail::uring_data>()}
+  {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries*2U;
+
+    auto& data = *data_;
+    data.ring_fd = ::io_uring_setup(entries, &params);
+    if (data.ring_fd==-1) {
+      throw socket_error{};
+    }
+
+    data.sq_ring_size = params.sq_off.array+params.sq_entries*sizeof(std::uint32_t);
+    data.cq_ring_size = params.cq_off.cqes+params.cq_entries*sizeof(io_uring_cqe);
+    if ((params.features & IORING_FEAT_SINGLE_MMAP)!=0U) {
+      data.sq_ring_size = data.cq_ring_size = std::max(data.sq_ring_size, data.cq_ring_size);
+    }
+
+    data.sq_ring = ::mmap(nullptr, data.sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, data.ring_fd,
+        IORING_OFF_SQ_RING);
+    if (data.sq_ring==MAP_FAILED) {
+      throw socket_error{};
+    }
+
+    if ((params.features & IORING_FEAT_SINGLE_MMAP)!=0U) {
+      data.cq_ring = data.sq_ring;
+    }
+    else {
+      data.cq_ring = ::mmap(nullptr, data.cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+          data.ring_fd, IORING_OFF_CQ_RING);
+      if (data.cq_ring==MAP_FAILED) {
+        throw socket_error{};
+      }
+    }
+
+    data.sqes_size = params.sq_entries*sizeof(io_uring_sqe);
+    data.sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, data.sqes_size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE, data.ring_fd, IORING_OFF_SQES));
+    if (data.sqes==MAP_FAILED) {
+      throw socket_error{};
+    }
+
+    data.sq_head = ::offset_ptr<std::uint32_t>(data.sq_ring, params.sq_off.head);
+    data.sq_tail = ::offset_ptr<std::uint32_t>(data.sq_ring, params.sq_off.tail);
+    data.sq_array = ::offset_ptr<std::uint32_t>(data.sq_ring, params.sq_off.array);
+    data.sq_mask = *::offset_ptr<std::uint32_t>(data.sq_ring, params.sq_off.ring_mask);
+    data.sq_entries = params.sq_entries;
+
+    data.cq_head = ::offset_ptr<std::uint32_t>(data.cq_ring, params.cq_off.head);
+    data.cq_tail = ::offset_ptr<std::uint32_t>(data.cq_ring, params.cq_off.tail);
+    data.cq_mask = *::offset_ptr<std::uint32_t>(data.cq_ring, params.cq_off.ring_mask);
+    data.cqes = ::offset_ptr<io_uring_cqe>(data.cq_ring, params.cq_off.cqes);
+
+    data.completions.reserve(params.cq_entries);
+
+    if (registered_sockets>0U) {
+      std::vector<int> const sparse(registered_sockets, -1);
+      if (::io_uring_register(data.ring_fd, IORING_REGISTER_FILES, sparse.data(), registered_sockets)==-1) {
+        throw socket_error{};
+      }
+      data.free_slots.reserve(registered_sockets);
+      for (auto slot = registered_sockets; slot>0U; --slot) {
+        data.free_slots.push_back(slot-1U);
+      }
+    }
+  }
+
+  uring_engine::~uring_engine() noexcept
+  {
+    data_->cancel_all();
+  }
+
+  std::uint32_t uring_engine::register_(traits::socket_t const sock)
+  {
+    if (data_->free_slots.empty()) {
+      throw socket_error{ENFILE};
+    }
+
+    auto const index = data_->free_slots.back();
+    io_uring_files_update update{};
+    update.offset = index;
+    update.fds = reinterpret_cast<std::uintptr_t>(&sock);
+    if (::io_uring_register(data_->ring_fd, IORING_REGISTER_FILES_UPDATE, &update, 1U)==-1) {
+      throw socket_error{};
+    }
+
+    data_->free_slots.pop_back();
+    return index;
+  }
+
+  void uring_engine::unregister_(std::uint32_t const index)
+  {
+    int const none{-1};
+    io_uring_files_update update{};
+    update.offset = index;
+    update.fds = reinterpret_cast<std::uintptr_t>(&none);
+    if (::io_uring_register(data_->ring_fd, IORING_REGISTER_FILES_UPDATE, &update, 1U)==-1) {
+      throw socket_error{};
+    }
+
+    data_->free_slots.push_back(index);
+  }
+
+  void uring_engine::send_(target const sock, gsl::span<std::byte const> const data, std::uint64_t const user_data)
+  {
+    auto& sqe = data_->next_sqe(sock.fd, sock.fixed, user_data);
+    sqe.opcode = IORING_OP_SEND;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(data.data());
+    sqe.len = ::clamp_length(data.size());
+    sqe.msg_flags = MSG_NOSIGNAL;
+  }
+
+  void uring_engine::send_to_(target const sock, address_v4_t const& address, gsl::span<std::byte const> const data,
+      std::uint64_t const user_data)
+  {
+    data_->send_to(sock.fd, sock.fixed, address, data, user_data);
+  }
+
+  void uring_engine::send_to_(target const sock, address_v6_t const& address, gsl::span<std::byte const> const data,
+      std::uint64_t const user_data)
+  {
+    data_->send_to(sock.fd, sock.fixed, address, data, user_data);
+  }
+
+  void uring_engine::receive_(target const sock, gsl::span<std::byte> const buffer, std::uint64_t const user_data)
+  {
+    auto& sqe = data_->next_sqe(sock.fd, sock.fixed, user_data);
+    sqe.opcode = IORING_OP_RECV;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(buffer.data());
+    sqe.len = ::clamp_length(buffer.size());
+  }
+
+  void uring_engine::receive_multishot_(target const sock, std::uint16_t const buffer_group,
+      std::uint64_t const user_data)
+  {
+    auto& sqe = data_->next_sqe(sock.fd, sock.fixed, user_data);
+    sqe.opcode = IORING_OP_RECV;
+    sqe.ioprio = IORING_RECV_MULTISHOT;
+    sqe.flags |= IOSQE_BUFFER_SELECT;
+    sqe.buf_group = buffer_group;
+  }
+
+  void uring_engine::accept_(target const sock, std::uint64_t const user_data, bool const multishot)
+  {
+    auto& sqe = data_->next_sqe(sock.fd, sock.fixed, user_data);
+    sqe.opcode = IORING_OP_ACCEPT;
+    sqe.accept_flags = SOCK_CLOEXEC;
+    if (multishot) {
+      sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+    }
+  }
+
+  void uring_engine::connect_(target const sock, address_v4_t const& address, std::uint64_t const user_data)
+  {
+    data_->connect(sock.fd, sock.fixed, address, user_data);
+  }
+
+  void uring_engine::connect_(target const sock, address_v6_t const& address, std::uint64_t const user_data)
+  {
+    data_->connect(sock.fd, sock.fixed, address, user_data);
+  }
+
+  void uring_engine::provide_buffers(std::uint16_t const buffer_group, gsl::span<std::byte> const storage,
+      std::size_t const buffer_size, std::uint16_t const first_id, std::uint64_t const user_data)
+  {
+    auto& sqe = data_->next_sqe(user_data);
+    sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe.fd = static_cast<std::int32_t>(storage.size()/buffer_size);
+    sqe.addr = reinterpret_cast<std::uintptr_t>(storage.data());
+    sqe.len = ::clamp_length(buffer_size);
+    sqe.off = first_id;
+    sqe.buf_group = buffer_group;
+  }
+
+  std::size_t uring_engine::submit()
+  {
+    auto const submitted = data_->to_submit;
+    data_->flush();
+    return submitted;
+  }
+
+  gsl::span<uring_engine::completion const> uring_engine::wait(std::size_t const min_completions)
+  {
+    auto& data = *data_;
+    for (;;) {
+      auto const available = ::load_acquire(data.cq_tail)-*data.cq_head;
+      if (available>=min_completions && data.to_submit==0U) {
+        break;
+      }
+
+      auto const result = ::io_uring_enter(data.ring_fd, data.to_submit,
+          static_cast<std::uint32_t>(min_completions), IORING_ENTER_GETEVENTS);
+      if (result==-1) {
+        if (errno==EINTR) {
+          continue;
+        }
+        throw socket_error{};
+      }
+      data.to_submit -= static_cast<std::uint32_t>(result);
+    }
+
+    data.reap();
+    return data.completions;
+  }
+
+  gsl::span<uring_engine::completion const> uring_engine::poll()
+  {
+    data_->flush();
+    data_->reap();
+    return data_->completions;
+  }
+}
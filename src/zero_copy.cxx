@@ -0,0 +1,167 @@
+#include <tss/zero_copy.hxx>
+#include <tss/exceptions.hxx>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace tss {
+  namespace detail {
+    struct zero_copy_data final {
+      // completion state of every pending send, starting with the one identified by oldest
+      std::deque<bool> window{};
+      std::uint32_t oldest{0U};
+      std::uint32_t next{0U};
+      std::size_t copied{0U};
+
+      /**
+       * Mark the sends from first to last (inclusive, wrapping) as completed.
+       * @return The number of sends that were not completed before.
+       */
+      std::size_t complete(std::uint32_t const first, std::uint32_t const last) noexcept
+      {
+        std::size_t completed{0U};
+        for (auto id = first;; ++id) {
+          if (auto const index = static_cast<std::uint32_t>(id-oldest); index<window.size() && !window[index]) {
+            window[index] = true;
+            ++completed;
+          }
+          if (id==last) {
+            break;
+          }
+        }
+
+        while (!window.empty() && window.front()) {
+          window.pop_front();
+          ++oldest;
+        }
+        return completed;
+      }
+    };
+  }
+
+  template<ip_version_t TIP>
+  zero_copy_sender<TIP>::zero_copy_sender(socket<TIP, protocol_t::TCP>& sock)
+      :sock_{&sock}, data_{std::make_unique<detail::zero_copy_data>()}
+  {
+    int const enable{1};
+    if (::setsockopt(sock.native_handle(), SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable))==-1) {
+      throw socket_error{};
+    }
+  }
+
+  template<ip_version_t TIP>
+  zero_copy_sender<TIP>::zero_copy_sender(zero_copy_sender&& src) noexcept
+  = default;
+
+  template<ip_version_t TIP>
+  zero_copy_sender<TIP>::~zero_copy_sender() noexcept
+  = default;
+
+  template<ip_version_t TIP>
+  zero_copy_sender<TIP>::traits::socket_t zero_copy_sender<TIP>::native_handle() const noexcept
+  {
+    return sock_->native_handle();
+  }
+
+  template<ip_version_t TIP>
+  zero_copy_send zero_copy_sender<TIP>::send(const_buffer const data)
+  {
+    return send(std::nothrow, data).value();
+  }
+
+  template<ip_version_t TIP>
+  result<zero_copy_send> zero_copy_sender<TIP>::send(std::nothrow_t, const_buffer const data) noexcept
+  {
+    auto const result = ::send(sock_->native_handle(), data.data(), data.size(), MSG_ZEROCOPY);
+    if (result==-1) {
+      return error_code::last();
+    }
+
+    // the kernel only numbers calls that actually transmitted something, empty ones get the id before the oldest
+    // pending send, which completed already
+    if (result==0) {
+      return zero_copy_send{0U, zero_copy_handle{data_->oldest-1U}};
+    }
+
+    zero_copy_handle const handle{data_->next++};
+    data_->window.push_back(false);
+    return zero_copy_send{static_cast<std::size_t>(result), handle};
+  }
+
+  template<ip_version_t TIP>
+  std::size_t zero_copy_sender<TIP>::reap()
+  {
+    std::size_t completed{0U};
+    for (;;) {
+      alignas(cmsghdr) std::array<char, CMSG_SPACE(sizeof(sock_extended_err))+64U> control{};
+      msghdr message{};
+      message.msg_control = control.data();
+      message.msg_controllen = control.size();
+
+      if (::recvmsg(sock_->native_handle(), &message, MSG_ERRQUEUE | MSG_DONTWAIT)==-1) {
+        if (errno==EAGAIN || errno==EWOULDBLOCK) {
+          return completed;
+        }
+        if (errno!=EINTR) {
+          throw socket_error{};
+        }
+        continue;
+      }
+
+      for (auto* header = CMSG_FIRSTHDR(&message); header!=nullptr; header = CMSG_NXTHDR(&message, header)) {
+        auto const is_error = (header->cmsg_level==SOL_IP && header->cmsg_type==IP_RECVERR) ||
+            (header->cmsg_level==SOL_IPV6 && header->cmsg_type==IPV6_RECVERR);
+        if (!is_error) {
+          continue;
+        }
+
+        sock_extended_err error{};
+        std::memcpy(&error, CMSG_DATA(header), sizeof(error));
+        if (error.ee_errno!=0 || error.ee_origin!=SO_EE_ORIGIN_ZEROCOPY) {
+          continue;
+        }
+
+        auto const newly_completed = data_->complete(error.ee_info, error.ee_data);
+        if ((error.ee_code & SO_EE_CODE_ZEROCOPY_COPIED)!=0U) {
+          data_->copied += newly_completed;
+        }
+        completed += newly_completed;
+      }
+    }
+  }
+
+  template<ip_version_t TIP>
+  bool zero_copy_sender<TIP>::is_complete(zero_copy_handle const handle) const noexcept
+  {
+    auto const index = static_cast<std::uint32_t>(handle.id-data_->oldest);
+    return index>=data_->window.size() || data_->window[index];
+  }
+
+  template<ip_version_t TIP>
+  std::size_t zero_copy_sender<TIP>::pending() const noexcept
+  {
+    std::size_t pending{0U};
+    for (auto const done: data_->window) {
+      pending += done ? 0U : 1U;
+    }
+    return pending;
+  }
+
+  template<ip_version_t TIP>
+  std::size_t zero_copy_sender<TIP>::copied() const noexcept
+  {
+    return data_->copied;
+  }
+
+  template
+  class zero_copy_sender<ip_version_t::V4>;
+
+  template
+  class zero_copy_sender<ip_version_t::V6>;
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <tss/async.hxx>
+
+#include <vector>
+
+namespace {
+  tss::task<int> add(int const lhs, int const rhs)
+  {
+    co_return lhs+rhs;
+  }
+}
+
+TEST(AsyncTests, tasksCanAwaitEachOther)
+{
+  tss::reactor loop{};
+  int result{};
+  loop.spawn([](int& result) -> tss::task<void> {
+    result = co_await add(20, 22);
+  }(result));
+  loop.run();
+  EXPECT_EQ(result, 42);
+}
+
+TEST(AsyncTests, exceptionsAreRethrownByRun)
+{
+  tss::reactor loop{};
+  loop.spawn([]() -> tss::task<void> {
+    co_await add(1, 2);
+    throw tss::exception{"failed"};
+  }());
+  EXPECT_THROW(loop.run(), tss::exception);
+}
+
+TEST(AsyncTests, canServeManyTcp4ConnectionsOnOneThread)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 54323U};
+  std::size_t constexpr clients = 32U;
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(clients);
+
+  tss::reactor loop{};
+
+  loop.spawn([](tss::reactor& loop, tss::tcp_socket_4& listener) -> tss::task<void> {
+    for (std::size_t i = 0U; i<clients; ++i) {
+      loop.spawn([](tss::reactor& loop, tss::tcp_socket_4 connection) -> tss::task<void> {
+        int value{};
+        EXPECT_EQ(co_await tss::async_receive(loop, connection, value), sizeof(int));
+        co_await tss::async_send(loop, connection, value+1);
+        loop.release(connection);
+      }(loop, co_await tss::async_accept(loop, listener)));
+    }
+    loop.release(listener);
+  }(loop, listener));
+
+  std::vector<int> answers(clients);
+  for (std::size_t i = 0U; i<clients; ++i) {
+    loop.spawn([](tss::reactor& loop, tss::address_v4_t address, int value, int& answer) -> tss::task<void> {
+      tss::tcp_socket_4 sock{};
+      co_await tss::async_connect(loop, sock, address);
+      co_await tss::async_send(loop, sock, value);
+      co_await tss::async_receive(loop, sock, answer);
+      loop.release(sock);
+    }(loop, address, static_cast<int>(i), answers[i]));
+  }
+
+  loop.run();
+
+  for (std::size_t i = 0U; i<clients; ++i) {
+    EXPECT_EQ(answers[i], static_cast<int>(i)+1);
+  }
+}
+
+TEST(AsyncTests, canSendAndReceiveOverUdp6)
+{
+  tss::address_v6_t const address{tss::resolve_ip_address_v6("::1"), 12351U};
+
+  tss::udp_socket_6 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_6 sender{};
+
+  tss::reactor loop{};
+  int received{};
+  loop.spawn([](tss::reactor& loop, tss::udp_socket_6& sock, int& received) -> tss::task<void> {
+    co_await tss::async_receive_from(loop, sock, nullptr, received);
+    loop.release(sock);
+  }(loop, receiver, received));
+  loop.spawn([](tss::reactor& loop, tss::udp_socket_6& sock, tss::address_v6_t address) -> tss::task<void> {
+    co_await tss::async_send_to(loop, sock, address, 42);
+    loop.release(sock);
+  }(loop, sender, address));
+
+  loop.run();
+  EXPECT_EQ(received, 42);
+}
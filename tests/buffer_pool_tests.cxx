@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <tss/buffer_pool.hxx>
+#include <tss/socket.hxx>
+
+#include "tcp_pair.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(BufferPoolTests, growsBySlabsUpToTheMaximum)
+{
+  tss::buffer_pool pool{128U, 6U, 4U, 2U};
+  EXPECT_EQ(pool.stats().allocated, 0U);
+
+  std::vector<tss::pooled_buffer> buffers{};
+  std::set<std::byte*> distinct{};
+  for (std::size_t i = 0U; i<6U; ++i) {
+    auto buffer = pool.acquire();
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(buffer.size(), 128U);
+    EXPECT_EQ(buffer.capacity(), 128U);
+    distinct.insert(buffer.data().data());
+    buffers.push_back(std::move(buffer));
+  }
+  EXPECT_EQ(distinct.size(), 6U);
+
+  auto const exhausted = pool.acquire(std::nothrow);
+  ASSERT_FALSE(exhausted);
+  EXPECT_EQ(exhausted.error(), tss::error_code::no_buffer_space());
+
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.allocated, 6U);
+  EXPECT_EQ(stats.in_use, 6U);
+  EXPECT_EQ(stats.peak_in_use, 6U);
+  EXPECT_EQ(stats.exhausted, 1U);
+
+  buffers.clear();
+  stats = pool.stats();
+  EXPECT_EQ(stats.in_use, 0U);
+  EXPECT_EQ(stats.peak_in_use, 6U);
+
+  // released buffers are handed out again instead of growing the pool
+  auto reused = pool.acquire();
+  EXPECT_TRUE(distinct.contains(reused.data().data()));
+  reused.reset();
+  EXPECT_FALSE(reused);
+  EXPECT_EQ(pool.stats().in_use, 0U);
+}
+
+TEST(BufferPoolTests, sharesBuffersAcrossThreads)
+{
+  std::size_t constexpr thread_count{4U};
+  tss::buffer_pool pool{64U, 256U, 16U, 8U};
+
+  std::vector<std::thread> threads{};
+  for (std::size_t t = 0U; t<thread_count; ++t) {
+    threads.emplace_back([&pool, t]() {
+      std::vector<tss::pooled_buffer> held{};
+      for (std::size_t round = 0U; round<2000U; ++round) {
+        while (held.size()<(round*7U+t)%32U+1U) {
+          auto buffer = pool.acquire();
+          std::fill(buffer.data().begin(), buffer.data().end(), static_cast<std::byte>(t));
+          held.push_back(std::move(buffer));
+        }
+        // every buffer still holds the pattern of its owner, so no buffer was handed out twice
+        for (auto const& buffer: held) {
+          ASSERT_TRUE(std::all_of(buffer.data().begin(), buffer.data().end(), [t](std::byte const value) {
+            return value==static_cast<std::byte>(t);
+          }));
+        }
+        held.resize(held.size()/2U);
+      }
+    });
+  }
+  for (auto& thread: threads) {
+    thread.join();
+  }
+
+  // exited threads returned their caches, so every buffer can be borrowed at once
+  auto const stats = pool.stats();
+  EXPECT_EQ(stats.in_use, 0U);
+  EXPECT_LE(stats.peak_in_use, 256U);
+  std::vector<tss::pooled_buffer> all{};
+  for (std::size_t i = 0U; i<stats.allocated; ++i) {
+    all.push_back(pool.acquire());
+  }
+  EXPECT_EQ(pool.stats().allocated, stats.allocated);
+}
+
+TEST(BufferPoolTests, socketsReceiveIntoPooledBuffers)
+{
+  tss::buffer_pool pool{64U, 16U};
+
+  tss::test::tcp_pair sockets{12400U};
+  sockets.client.send(std::uint64_t{42U});
+  auto const stream = sockets.server.receive(pool);
+  ASSERT_EQ(stream.size(), sizeof(std::uint64_t));
+  EXPECT_EQ(pool.stats().in_use, 1U);
+
+  sockets.client.shutdown(tss::shutdown_t::Write);
+  EXPECT_FALSE(sockets.server.receive(pool));
+  EXPECT_EQ(pool.stats().in_use, 1U);
+
+  tss::address_v4_t const datagram_address{tss::resolve_ip_address_v4("127.0.0.1"), 12401U};
+  tss::udp_socket_4 receiver{};
+  receiver.set_reuse_addr();
+  receiver.bind(datagram_address);
+  receiver.set_non_blocking();
+  tss::udp_socket_4 sender{};
+  for (std::uint32_t i = 0U; i<3U; ++i) {
+    sender.send_to(datagram_address, i);
+  }
+
+  tss::address_v4_t from{};
+  auto const first = receiver.receive_from(&from, pool);
+  ASSERT_EQ(first.size(), sizeof(std::uint32_t));
+
+  std::array<tss::pooled_datagram<tss::ip_version_t::V4>, 4U> datagrams{};
+  EXPECT_EQ(receiver.receive_batch(pool, gsl::span{datagrams}), 2U);
+  EXPECT_EQ(datagrams[0U].buffer.size(), sizeof(std::uint32_t));
+  EXPECT_EQ(datagrams[1U].buffer.size(), sizeof(std::uint32_t));
+  EXPECT_FALSE(datagrams[2U].buffer);
+  EXPECT_FALSE(datagrams[3U].buffer);
+  EXPECT_EQ(pool.stats().in_use, 4U);
+
+  auto const nothing = receiver.receive_from(std::nothrow, nullptr, pool);
+  ASSERT_FALSE(nothing);
+  EXPECT_TRUE(nothing.error().would_block());
+  EXPECT_EQ(pool.stats().in_use, 4U);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <tss/buffered_stream.hxx>
+#include <tss/exceptions.hxx>
+#include <tss/socket.hxx>
+
+#include "tcp_pair.hxx"
+
+#include <csignal>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+TEST(BufferedStreamTests, coalescesSmallSendsAndReceives)
+{
+  tss::test::tcp_pair sockets{12376U};
+  tss::buffered_stream writer{sockets.client, 256U};
+  tss::buffered_stream reader{sockets.server, 1024U, 256U};
+
+  for (std::uint32_t i = 0U; i<64U; ++i) {
+    writer.send(i);
+  }
+  EXPECT_EQ(writer.pending(), 256U);
+  writer.send(std::uint64_t{64U});
+  EXPECT_EQ(writer.pending(), sizeof(std::uint64_t));
+  writer.flush();
+  EXPECT_EQ(writer.pending(), 0U);
+
+  for (std::uint32_t i = 0U; i<64U; ++i) {
+    std::uint32_t value{};
+    ASSERT_EQ(reader.receive(value), sizeof(value));
+    EXPECT_EQ(value, i);
+  }
+  std::uint64_t last{};
+  EXPECT_EQ(reader.receive(last), sizeof(last));
+  EXPECT_EQ(last, 64U);
+  EXPECT_EQ(reader.available(), 0U);
+
+  if constexpr (tss::stats_enabled) {
+    EXPECT_EQ(sockets.client.stats()[tss::io_operation_t::Send].calls, 2U);
+  }
+}
+
+TEST(BufferedStreamTests, passesLargeTransfersThroughAndEndsAtEndOfStream)
+{
+  tss::test::tcp_pair sockets{12377U};
+  std::vector<std::uint32_t> large(64U*1024U);
+  std::iota(large.begin(), large.end(), 0U);
+
+  std::thread sender{[&sockets, &large] {
+    tss::buffered_stream writer{sockets.client, 1024U};
+    writer.send(std::uint16_t{7U});
+    writer.send(gsl::span<std::uint32_t const>{large});
+    EXPECT_EQ(writer.pending(), 0U);
+    writer.send(std::uint16_t{8U});
+    writer.flush();
+    sockets.client.shutdown(tss::shutdown_t::Write);
+  }};
+
+  tss::buffered_stream reader{sockets.server, 1024U, 1024U};
+  std::uint16_t first{};
+  EXPECT_EQ(reader.receive(first), sizeof(first));
+  EXPECT_EQ(first, 7U);
+
+  std::vector<std::uint32_t> received(large.size());
+  EXPECT_EQ(reader.receive(gsl::span<std::uint32_t>{received}), received.size()*sizeof(std::uint32_t));
+  EXPECT_EQ(received, large);
+
+  std::uint16_t second{};
+  EXPECT_EQ(reader.receive(second), sizeof(second));
+  EXPECT_EQ(second, 8U);
+
+  std::uint32_t past_end{};
+  EXPECT_EQ(reader.receive(past_end), 0U);
+  sender.join();
+}
+
+TEST(BufferedStreamTests, flushesRequestsBeforeAwaitingResponses)
+{
+  tss::test::tcp_pair sockets{12378U};
+  std::thread echo{[&sockets] {
+    tss::buffered_stream stream{sockets.server, 1024U, 1024U, tss::flush_t::Manual};
+    std::uint64_t value{};
+    while (stream.receive(value)==sizeof(value)) {
+      stream.send(value+1U);
+      stream.flush();
+    }
+  }};
+
+  {
+    tss::buffered_stream stream{sockets.client};
+    for (std::uint64_t i = 0U; i<100U; ++i) {
+      stream.send(i);
+      std::uint64_t response{};
+      ASSERT_EQ(stream.receive(response), sizeof(response));
+      EXPECT_EQ(response, i+1U);
+    }
+  }
+  sockets.client.shutdown(tss::shutdown_t::Write);
+  echo.join();
+}
+
+TEST(BufferedStreamTests, dropsSentDataWhenTheConnectionBreaksMidTransfer)
+{
+#if !defined(_WIN32)
+  // sending on the broken connection must fail with an error instead of a signal
+  std::signal(SIGPIPE, SIG_IGN);
+#endif
+  tss::test::tcp_pair sockets{12406U};
+  tss::buffered_stream writer{sockets.client, 256U};
+  writer.send(std::uint64_t{1U});
+
+  // the peer goes away with data left unread, which resets the connection while the large send is in progress
+  std::thread peer{[&sockets] {
+    std::vector<std::byte> buffer(1024U);
+    (void) sockets.server.receive(gsl::span<std::byte>{buffer});
+    sockets.server.close();
+  }};
+
+  std::vector<std::byte> const large(16U*1024U*1024U);
+  EXPECT_THROW(writer.send(gsl::span<std::byte const>{large}), tss::socket_error);
+  peer.join();
+  EXPECT_EQ(writer.pending(), 0U);
+}
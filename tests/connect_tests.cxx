@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <tss/connect.hxx>
+#include <tss/exceptions.hxx>
+
+#include <array>
+#include <chrono>
+#include <variant>
+
+TEST(ConnectTests, connectsToTheOnlyFamilyThatAnswers)
+{
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind({tss::resolve_ip_address_v4("127.0.0.1"), 12364U});
+  listener.listen(5);
+
+  // nothing listens on the IPv6 loopback, so that attempt is refused and the IPv4 one wins
+  std::array<std::variant<tss::ip_address_v4_t, tss::ip_address_v6_t>, 2U> const addresses{
+      tss::ip_address_v4_t{127U, 0U, 0U, 1U},
+      tss::ip_address_v6_t{0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U},
+  };
+  auto sock = tss::connect_any(addresses, 12364U);
+  ASSERT_TRUE(std::holds_alternative<tss::tcp_socket_4>(sock));
+
+  auto server = listener.accept(nullptr);
+  std::get<tss::tcp_socket_4>(sock).send(42);
+  int value{};
+  server.receive(value);
+  EXPECT_EQ(value, 42);
+
+  auto const resolved = tss::connect_any("127.0.0.1", 12364U);
+  EXPECT_TRUE(std::holds_alternative<tss::tcp_socket_4>(resolved));
+}
+
+TEST(ConnectTests, prefersIpv6)
+{
+  tss::tcp_socket_4 listener_4{};
+  listener_4.set_reuse_addr();
+  listener_4.bind({tss::resolve_ip_address_v4("127.0.0.1"), 12365U});
+  listener_4.listen(5);
+
+  tss::tcp_socket_6 listener_6{};
+  listener_6.set_reuse_addr();
+  listener_6.bind({tss::resolve_ip_address_v6("::1"), 12365U});
+  listener_6.listen(5);
+
+  std::array<std::variant<tss::ip_address_v4_t, tss::ip_address_v6_t>, 2U> const addresses{
+      tss::ip_address_v4_t{127U, 0U, 0U, 1U},
+      tss::ip_address_v6_t{0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U},
+  };
+  auto const raced = tss::connect_any(addresses, 12365U, std::chrono::milliseconds{1000});
+  EXPECT_TRUE(std::holds_alternative<tss::tcp_socket_6>(raced));
+}
+
+TEST(ConnectTests, reportsTheLastErrorIfNothingAnswers)
+{
+  std::array<std::variant<tss::ip_address_v4_t, tss::ip_address_v6_t>, 2U> const addresses{
+      tss::ip_address_v4_t{127U, 0U, 0U, 1U},
+      tss::ip_address_v6_t{0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U},
+  };
+  EXPECT_THROW(tss::connect_any(addresses, 12366U), tss::socket_error);
+}
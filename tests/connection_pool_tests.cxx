@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <tss/connection_pool.hxx>
+#include <tss/exceptions.hxx>
+
+#include <chrono>
+#include <optional>
+#include <thread>
+
+TEST(ConnectionPoolTests, reusesReturnedConnections)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12367U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  tss::connection_pool<tss::ip_version_t::V4> pool{};
+
+  tss::native::socket_traits::socket_t handle{};
+  {
+    auto lease = pool.acquire(address);
+    handle = lease->native_handle();
+    lease->send(42);
+    EXPECT_EQ(pool.size(), 1U);
+    EXPECT_EQ(pool.idle(), 0U);
+  }
+  EXPECT_EQ(pool.idle(), 1U);
+
+  auto server = listener.accept(nullptr);
+  int value{};
+  server.receive(value);
+  EXPECT_EQ(value, 42);
+
+  auto lease = pool.acquire(address);
+  EXPECT_EQ(lease->native_handle(), handle);
+  EXPECT_EQ(pool.size(), 1U);
+}
+
+TEST(ConnectionPoolTests, enforcesTheLimitPerServer)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12368U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  tss::connection_pool<tss::ip_version_t::V4> pool{1U};
+
+  auto first = pool.acquire(address);
+  EXPECT_THROW(pool.acquire(address, std::chrono::milliseconds{10}), tss::socket_error);
+
+  auto sock = std::move(first).release();
+  EXPECT_TRUE(sock.is_valid());
+  EXPECT_EQ(pool.size(), 0U);
+
+  auto second = pool.acquire(address);
+  second.discard();
+}
+
+TEST(ConnectionPoolTests, replacesDeadConnectionsAndEvictsIdleOnes)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12369U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  tss::connection_pool<tss::ip_version_t::V4> pool{2U, std::chrono::milliseconds{0}};
+  { auto const lease = pool.acquire(address); }
+
+  // the server closing the connection makes it unusable
+  listener.accept(nullptr).close();
+  {
+    auto lease = pool.acquire(address);
+    lease->send(7);
+    EXPECT_EQ(pool.size(), 1U);
+  }
+
+  auto server = listener.accept(nullptr);
+  int value{};
+  server.receive(value);
+  EXPECT_EQ(value, 7);
+
+  EXPECT_EQ(pool.evict_idle(), 1U);
+  EXPECT_EQ(pool.size(), 0U);
+}
+
+TEST(ConnectionPoolTests, wakesWaitersOfTheReturningServerInASharedShard)
+{
+  tss::address_v4_t const first_address{tss::resolve_ip_address_v4("127.0.0.1"), 12404U};
+  tss::address_v4_t const second_address{tss::resolve_ip_address_v4("127.0.0.1"), 12405U};
+
+  tss::tcp_socket_4 first_listener{};
+  first_listener.set_reuse_addr();
+  first_listener.bind(first_address);
+  first_listener.listen(5);
+  tss::tcp_socket_4 second_listener{};
+  second_listener.set_reuse_addr();
+  second_listener.bind(second_address);
+  second_listener.listen(5);
+
+  // a single shard makes the waiters for both servers share one condition
+  tss::connection_pool<tss::ip_version_t::V4> pool{1U, std::chrono::seconds{30}, 1U};
+  std::optional first{pool.acquire(first_address)};
+  auto second = pool.acquire(second_address);
+
+  // the waiter for the second server blocks first, so it would be the one to get a single wakeup
+  std::thread second_waiter{[&pool, &second_address] {
+    EXPECT_NO_THROW((void) pool.acquire(second_address, std::chrono::seconds{5}));
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  std::thread first_waiter{[&pool, &first_address] {
+    EXPECT_NO_THROW((void) pool.acquire(first_address, std::chrono::seconds{5}));
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+  // a lost wakeup would only be noticed when the waiter gives up, so it must get the connection long before
+  auto const returned_at = std::chrono::steady_clock::now();
+  first.reset();
+  first_waiter.join();
+  EXPECT_LT(std::chrono::steady_clock::now()-returned_at, std::chrono::seconds{2});
+  { auto const returned = std::move(second); }
+  second_waiter.join();
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
 #include <tss/exceptions.hxx>
+#include <tss/result.hxx>
+
+#include <cerrno>
 
 TEST(ExceptionsTests, baseExceptionIsCopyable)
 {
@@ -22,3 +25,29 @@ TEST(ExceptionsTests, addressInfoErrorIsCopyable)
   tss::address_info_error const ex2{ex};
   EXPECT_STREQ(ex.what(), ex2.what());
 }
+
+TEST(ExceptionsTests, failedResultThrowsSocketErrorOnAccess)
+{
+  tss::result<int> const result{tss::error_code{EINVAL}};
+  EXPECT_FALSE(result.has_value());
+  EXPECT_EQ(result.error(), tss::error_code{EINVAL});
+  EXPECT_FALSE(result.error().message().empty());
+  EXPECT_THROW((void) result.value(), tss::socket_error);
+}
+
+TEST(ExceptionsTests, errorCodeRecognizesAbortedConnections)
+{
+  EXPECT_FALSE(tss::error_code{EINVAL}.connection_aborted());
+#if !defined(_WIN32)
+  EXPECT_TRUE(tss::error_code{ECONNABORTED}.connection_aborted());
+  EXPECT_TRUE(tss::error_code{EPROTO}.connection_aborted());
+#endif
+}
+
+TEST(ExceptionsTests, successfulResultHoldsValue)
+{
+  tss::result<int> const result{42};
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result.value(), 42);
+  EXPECT_EQ(*result, 42);
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <tss/exceptions.hxx>
+#include <tss/framing.hxx>
+#include <tss/socket.hxx>
+
+#include "tcp_pair.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+  std::vector<std::byte> payload(std::size_t const size)
+  {
+    std::vector<std::byte> bytes(size);
+    for (std::size_t i = 0U; i<size; ++i) {
+      bytes[i] = static_cast<std::byte>(i*7U+size);
+    }
+    return bytes;
+  }
+}
+
+TEST(FramingTests, encodesLengthsInTheConfiguredByteOrder)
+{
+  std::array<std::byte, 8U> header{};
+
+  tss::encode_frame_header(tss::frame_format{}, 0x0102U, tss::mutable_buffer{header});
+  EXPECT_EQ(header[0U], std::byte{0x00});
+  EXPECT_EQ(header[1U], std::byte{0x00});
+  EXPECT_EQ(header[2U], std::byte{0x01});
+  EXPECT_EQ(header[3U], std::byte{0x02});
+  EXPECT_EQ(tss::decode_frame_header(tss::frame_format{}, tss::const_buffer{header}), 0x0102U);
+
+  tss::frame_format const little{2U, std::endian::little};
+  tss::encode_frame_header(little, 0x0102U, tss::mutable_buffer{header});
+  EXPECT_EQ(header[0U], std::byte{0x02});
+  EXPECT_EQ(header[1U], std::byte{0x01});
+  EXPECT_EQ(tss::decode_frame_header(little, tss::const_buffer{header}), 0x0102U);
+
+  tss::frame_format const wide{8U};
+  tss::encode_frame_header(wide, 0x0102030405060708U, tss::mutable_buffer{header});
+  EXPECT_EQ(header[0U], std::byte{0x01});
+  EXPECT_EQ(header[7U], std::byte{0x08});
+  EXPECT_EQ(tss::decode_frame_header(wide, tss::const_buffer{header}), 0x0102030405060708U);
+
+  tss::frame_format const narrow{1U};
+  tss::encode_frame_header(narrow, 255U, tss::mutable_buffer{header});
+  EXPECT_EQ(tss::decode_frame_header(narrow, tss::const_buffer{header}), 255U);
+  EXPECT_THROW(tss::encode_frame_header(narrow, 256U, tss::mutable_buffer{header}), tss::frame_error);
+}
+
+TEST(FramingTests, transfersBatchesOfFrames)
+{
+  tss::test::tcp_pair sockets{12396U};
+  tss::frame_writer writer{sockets.client};
+  tss::frame_reader reader{sockets.server, tss::frame_format{}, 256U};
+
+  // more frames than fit into one vectored send, some empty and some larger than the receive buffer
+  std::vector<std::vector<std::byte>> sent{};
+  for (std::size_t i = 0U; i<100U; ++i) {
+    sent.push_back(payload(i%10U==0U ? 1000U+i : i%7U));
+  }
+  std::vector<tss::const_buffer> payloads(sent.begin(), sent.end());
+
+  std::thread sender{[&writer, &payloads]() {
+    writer.send(tss::const_buffer{payloads[0U]});
+    writer.send(gsl::span<tss::const_buffer const>{payloads}.subspan(1U));
+  }};
+
+  for (auto const& expected: sent) {
+    auto const frame = reader.receive();
+    ASSERT_TRUE(frame);
+    ASSERT_EQ(frame->size(), expected.size());
+    EXPECT_TRUE(std::equal(frame->begin(), frame->end(), expected.begin()));
+  }
+  sender.join();
+
+  sockets.client.shutdown(tss::shutdown_t::Write);
+  EXPECT_FALSE(reader.receive());
+  EXPECT_EQ(reader.buffered(), 0U);
+}
+
+TEST(FramingTests, assemblesFramesSplitAcrossReceives)
+{
+  tss::test::tcp_pair sockets{12397U};
+  tss::frame_format const format{2U};
+  tss::frame_reader reader{sockets.server, format, 16U};
+
+  std::array<std::byte, 2U> header{};
+  tss::encode_frame_header(format, 3U, tss::mutable_buffer{header});
+  auto const body = payload(3U);
+
+  // the header arrives in two parts, followed by the payload and a second frame in one receive
+  sockets.client.send(gsl::span<std::byte const>{header}.first(1U));
+  ASSERT_EQ(reader.fill(std::nothrow).value(), 1U);
+  EXPECT_FALSE(reader.next());
+
+  sockets.client.send(gsl::span<std::byte const>{header}.subspan(1U));
+  ASSERT_EQ(reader.fill(std::nothrow).value(), 1U);
+  EXPECT_FALSE(reader.next());
+
+  std::vector<std::byte> rest{body};
+  rest.insert(rest.end(), header.begin(), header.end());
+  rest.insert(rest.end(), body.begin(), body.end());
+  sockets.client.send(gsl::span<std::byte const>{rest});
+  std::size_t received{0U};
+  while (received<rest.size()) {
+    received += reader.fill(std::nothrow).value();
+  }
+
+  auto const first = reader.next();
+  auto const second = reader.next();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  EXPECT_TRUE(std::equal(first->begin(), first->end(), body.begin(), body.end()));
+  EXPECT_TRUE(std::equal(second->begin(), second->end(), body.begin(), body.end()));
+  EXPECT_FALSE(reader.next());
+  EXPECT_EQ(reader.buffered(), 0U);
+}
+
+TEST(FramingTests, rejectsProtocolViolations)
+{
+  {
+    tss::test::tcp_pair sockets{12398U};
+    tss::frame_reader reader{sockets.server, tss::frame_format{4U, std::endian::big, 64U}};
+    tss::frame_writer writer{sockets.client};
+
+    auto const large = payload(65U);
+    writer.send(tss::const_buffer{large});
+    EXPECT_THROW((void) reader.receive(), tss::frame_error);
+  }
+  {
+    tss::test::tcp_pair sockets{12399U};
+    tss::frame_reader reader{sockets.server};
+
+    std::array<std::byte, 6U> truncated{};
+    tss::encode_frame_header(tss::frame_format{}, 10U, tss::mutable_buffer{truncated});
+    sockets.client.send(gsl::span<std::byte const>{truncated});
+    sockets.client.shutdown(tss::shutdown_t::Write);
+    EXPECT_THROW((void) reader.receive(), tss::frame_error);
+  }
+}
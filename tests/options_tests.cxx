@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <tss/exceptions.hxx>
+#include <tss/options.hxx>
+#include <tss/socket.hxx>
+
+#include <cstddef>
+
+template<typename TSocket, typename TOption>
+concept settable = requires(TSocket& sock, typename TOption::value_type value) {
+  sock.template set<TOption>(value);
+};
+
+static_assert(settable<tss::tcp_socket_4, tss::options::tcp_nodelay>);
+static_assert(!settable<tss::udp_socket_4, tss::options::tcp_nodelay>);
+static_assert(settable<tss::udp_socket_6, tss::options::udp_gro>);
+static_assert(!settable<tss::tcp_socket_6, tss::options::udp_gro>);
+static_assert(settable<tss::tcp_socket_4, tss::options::ip_tos>);
+static_assert(!settable<tss::tcp_socket_6, tss::options::ip_tos>);
+static_assert(settable<tss::udp_socket_6, tss::options::ipv6_v6only>);
+static_assert(!settable<tss::udp_socket_4, tss::options::ipv6_v6only>);
+
+TEST(OptionsTests, canSetAndGetTcpOptions)
+{
+  tss::tcp_socket_4 sock{};
+  EXPECT_FALSE(sock.get<tss::options::tcp_nodelay>());
+  sock.set<tss::options::tcp_nodelay>(true);
+  EXPECT_TRUE(sock.get<tss::options::tcp_nodelay>());
+
+  sock.set<tss::options::keep_alive>(true);
+  EXPECT_TRUE(sock.get<tss::options::keep_alive>());
+
+  sock.set<tss::options::send_buffer_size>(64U*1024U);
+  EXPECT_GE(sock.get<tss::options::send_buffer_size>(), std::size_t{64U*1024U});
+
+  sock.set<tss::options::tcp_notsent_lowat>(16384U);
+  EXPECT_EQ(sock.get<tss::options::tcp_notsent_lowat>(), 16384U);
+
+  sock.set<tss::options::ip_tos>(0x10U);
+  EXPECT_EQ(sock.get<tss::options::ip_tos>(), 0x10U);
+
+  // values beyond the range of the native int are rejected instead of wrapping around
+  EXPECT_THROW(sock.set<tss::options::send_buffer_size>(std::size_t{1U} << 31U), tss::socket_error);
+  EXPECT_THROW(sock.set<tss::options::tcp_notsent_lowat>(0x80000000U), tss::socket_error);
+  EXPECT_GE(sock.get<tss::options::send_buffer_size>(), std::size_t{64U*1024U});
+}
+
+TEST(OptionsTests, appliesOptionsAtCreation)
+{
+  tss::tcp_socket_6 sock{
+      tss::options::reuse_addr{true},
+      tss::options::ipv6_v6only{true},
+      tss::options::receive_buffer_size{128U*1024U}
+  };
+  EXPECT_TRUE(sock.get_reuse_addr());
+  EXPECT_TRUE(sock.get<tss::options::ipv6_v6only>());
+  EXPECT_GE(sock.get<tss::options::receive_buffer_size>(), std::size_t{128U*1024U});
+
+  tss::udp_socket_4 datagram{};
+  datagram.apply(tss::options::reuse_addr{true}, tss::options::send_buffer_size{32U*1024U});
+  EXPECT_TRUE(datagram.get<tss::options::reuse_addr>());
+}
+
+#if defined(__linux__)
+
+TEST(OptionsTests, canSetLinuxOptions)
+{
+  tss::tcp_socket_4 sock{tss::options::tcp_cork{true}, tss::options::priority{3}};
+  EXPECT_TRUE(sock.get<tss::options::tcp_cork>());
+  EXPECT_EQ(sock.get<tss::options::priority>(), 3);
+
+  tss::udp_socket_4 datagram{tss::options::udp_segment{1200U}};
+  EXPECT_EQ(datagram.get<tss::options::udp_segment>(), 1200U);
+  EXPECT_EQ(datagram.get_segment_size(), 1200U);
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <tss/poller.hxx>
+#include <tss/socket.hxx>
+
+TEST(PollerTests, reportsReadableSocketsWithUserData)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12346U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  int marker{};
+  tss::poller poller{};
+  poller.add(receiver, tss::poll_event_t::Read, &marker);
+  EXPECT_EQ(poller.size(), 1U);
+
+  EXPECT_TRUE(poller.wait().empty());
+
+  sender.send_to(address, 42);
+
+  auto const events = poller.wait(std::chrono::milliseconds{1000});
+  ASSERT_EQ(events.size(), 1U);
+  EXPECT_TRUE(events[0].is(receiver));
+  EXPECT_TRUE(events[0].is_read());
+  EXPECT_FALSE(events[0].is_write());
+  EXPECT_EQ(events[0].user_data, &marker);
+
+  int value{};
+  receiver.receive_from(nullptr, value);
+  EXPECT_EQ(value, 42);
+}
+
+TEST(PollerTests, keepsRegistrationsAcrossWaits)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12347U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  tss::poller poller{};
+  poller.add(receiver, tss::poll_event_t::Read);
+
+  for (int i = 0; i<3; ++i) {
+    sender.send_to(address, i);
+
+    auto const events = poller.wait(std::chrono::milliseconds{1000});
+    ASSERT_EQ(events.size(), 1U);
+    EXPECT_TRUE(events[0].is(receiver));
+
+    int value{};
+    receiver.receive_from(nullptr, value);
+    EXPECT_EQ(value, i);
+  }
+
+  poller.remove(receiver);
+  EXPECT_EQ(poller.size(), 0U);
+
+  sender.send_to(address, 23);
+  EXPECT_TRUE(poller.wait(std::chrono::milliseconds{100}).empty());
+}
+
+TEST(PollerTests, edgeTriggeredReportsEachChangeOnce)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12348U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  tss::poller poller{};
+  poller.add(receiver, tss::poll_event_t::Read, nullptr, tss::trigger_t::Edge);
+
+  sender.send_to(address, 1);
+  EXPECT_EQ(poller.wait(std::chrono::milliseconds{1000}).size(), 1U);
+  EXPECT_TRUE(poller.wait().empty());
+}
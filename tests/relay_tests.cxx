@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <tss/relay.hxx>
+#include <tss/socket.hxx>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST(RelayTests, forwardsBothDirectionsIncludingHalfClose)
+{
+  tss::address_v4_t const front_address{tss::resolve_ip_address_v4("127.0.0.1"), 12362U};
+  tss::address_v4_t const back_address{tss::resolve_ip_address_v4("127.0.0.1"), 12363U};
+
+  tss::tcp_socket_4 front_listener{};
+  front_listener.set_reuse_addr();
+  front_listener.bind(front_address);
+  front_listener.listen(5);
+
+  tss::tcp_socket_4 back_listener{};
+  back_listener.set_reuse_addr();
+  back_listener.bind(back_address);
+  back_listener.listen(5);
+
+  tss::tcp_socket_4 client{};
+  client.connect(front_address);
+  auto front = front_listener.accept(nullptr);
+
+  tss::tcp_socket_4 back{};
+  back.connect(back_address);
+  auto upstream = back_listener.accept(nullptr);
+
+  tss::relay relay{front, back};
+  std::thread forwarder{[&relay] {
+    EXPECT_TRUE(relay.run());
+  }};
+
+  std::vector<std::uint32_t> request(1U<<18U);
+  for (std::size_t i = 0U; i<request.size(); ++i) {
+    request[i] = static_cast<std::uint32_t>(i);
+  }
+  std::vector<std::uint32_t> const response(1000U, 7U);
+
+  std::thread server{[&upstream, &request, &response] {
+    std::vector<std::uint32_t> received(request.size());
+    EXPECT_EQ(upstream.receive_exact(gsl::span<std::uint32_t>{received}), request.size()*sizeof(std::uint32_t));
+    EXPECT_EQ(received, request);
+
+    std::uint32_t rest{};
+    EXPECT_EQ(upstream.receive_exact(rest), 0U);
+
+    upstream.send_all(gsl::span<std::uint32_t const>{response});
+    upstream.shutdown(tss::shutdown_t::Write);
+  }};
+
+  client.send_all(gsl::span<std::uint32_t const>{request});
+  client.shutdown(tss::shutdown_t::Write);
+
+  std::vector<std::uint32_t> received(response.size());
+  EXPECT_EQ(client.receive_exact(gsl::span<std::uint32_t>{received}), response.size()*sizeof(std::uint32_t));
+  EXPECT_EQ(received, response);
+  std::uint32_t rest{};
+  EXPECT_EQ(client.receive_exact(rest), 0U);
+
+  server.join();
+  forwarder.join();
+
+  EXPECT_TRUE(relay.is_done());
+  EXPECT_EQ(relay.first_to_second(), request.size()*sizeof(std::uint32_t));
+  EXPECT_EQ(relay.second_to_first(), response.size()*sizeof(std::uint32_t));
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <tss/exceptions.hxx>
+#include <tss/resolver.hxx>
+
+#include <array>
+#include <string_view>
+
+TEST(ResolverTests, resolvesAndCachesAddresses)
+{
+  tss::resolver resolver{2U};
+
+  auto const first = resolver.resolve_v4("127.0.0.1");
+  auto const second = resolver.resolve_v4("127.0.0.1");
+  EXPECT_EQ(resolver.size(), 1U);
+
+  tss::ip_address_v4_t const expected{127U, 0U, 0U, 1U};
+  ASSERT_EQ(first.get().size(), 1U);
+  EXPECT_EQ(first.get()[0U], expected);
+  EXPECT_EQ(second.get(), first.get());
+
+  auto const v6 = resolver.resolve_v6("::1").get();
+  ASSERT_EQ(v6.size(), 1U);
+  EXPECT_EQ(v6[0U], (tss::ip_address_v6_t{0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U}));
+  EXPECT_EQ(resolver.size(), 2U);
+
+  resolver.clear();
+  EXPECT_EQ(resolver.size(), 0U);
+}
+
+TEST(ResolverTests, resolvesManyHostsWithoutDuplicates)
+{
+  tss::resolver resolver{};
+
+  std::array<std::string_view, 3U> const hosts{"127.0.0.1", "127.0.0.2", "::1"};
+  auto const results = resolver.resolve(hosts);
+  ASSERT_EQ(results.size(), hosts.size());
+  for (auto const& result: results) {
+    EXPECT_EQ(result.get().size(), 1U);
+  }
+  EXPECT_TRUE(std::holds_alternative<tss::ip_address_v6_t>(results[2U].get()[0U]));
+}
+
+TEST(ResolverTests, doesNotCacheFailuresAndExpiresResults)
+{
+  tss::resolver resolver{1U, std::chrono::seconds{0}};
+
+  auto const failed = resolver.resolve("name.invalid");
+  EXPECT_THROW(failed.get(), tss::address_info_error);
+  EXPECT_EQ(resolver.size(), 0U);
+
+  resolver.resolve_v4("127.0.0.1").get();
+  resolver.purge();
+  EXPECT_EQ(resolver.size(), 0U);
+}
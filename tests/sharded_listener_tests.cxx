@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <tss/poller.hxx>
+#include <tss/sharded_listener.hxx>
+#include <tss/socket.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <sched.h>
+
+TEST(ShardedListenerTests, acceptsConnectionsOnAllShards)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12370U};
+  tss::sharded_listener<tss::ip_version_t::V4, tss::protocol_t::TCP> listener{address, 3U};
+  ASSERT_EQ(listener.size(), 3U);
+
+  tss::poller poller{};
+  for (auto& shard: listener) {
+    EXPECT_TRUE(shard.get_reuse_port());
+    shard.set_non_blocking();
+    poller.add(shard, tss::poll_event_t::Read);
+  }
+
+  std::vector<tss::tcp_socket_4> clients(32U);
+  for (auto& client: clients) {
+    client.connect(address);
+  }
+
+  std::size_t accepted{0U};
+  while (accepted<clients.size()) {
+    auto const events = poller.wait(std::chrono::seconds{5});
+    ASSERT_FALSE(events.empty());
+    for (auto const& event: events) {
+      for (auto& shard: listener) {
+        if (!event.is(shard)) {
+          continue;
+        }
+        while (shard.accept(std::nothrow, nullptr)) {
+          ++accepted;
+        }
+      }
+    }
+  }
+  EXPECT_EQ(accepted, clients.size());
+}
+
+TEST(ShardedListenerTests, steersDatagramsByCpu)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12371U};
+  constexpr std::size_t shard_count{4U};
+  tss::sharded_listener<tss::ip_version_t::V4, tss::protocol_t::UDP> listener{
+      address,
+      shard_count,
+      tss::steering_t::Cpu
+  };
+  for (auto& shard: listener) {
+    shard.set_non_blocking();
+  }
+
+  cpu_set_t allowed{};
+  ASSERT_EQ(::sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+
+  std::size_t tested{0U};
+  for (std::size_t cpu = 0U; cpu<CPU_SETSIZE && tested<shard_count; ++cpu) {
+    if (!CPU_ISSET(cpu, &allowed)) {
+      continue;
+    }
+    ++tested;
+
+    // on loopback the receive path runs on the sending CPU, and many flows rule out a lucky hash
+    constexpr std::uint32_t senders{16U};
+    std::thread worker{[&address, cpu] {
+      tss::pin_current_thread(cpu);
+      std::vector<tss::udp_socket_4> sockets(senders);
+      for (std::uint32_t i = 0U; i<senders; ++i) {
+        sockets[i].send_to(address, i);
+      }
+    }};
+    worker.join();
+
+    std::vector<bool> seen(senders);
+    for (std::size_t index = 0U; index<listener.size(); ++index) {
+      std::uint32_t value{};
+      while (listener[index].receive_from(std::nothrow, nullptr, value)) {
+        EXPECT_EQ(index, cpu%shard_count) << "datagram " << value << " sent from CPU " << cpu;
+        ASSERT_LT(value, senders);
+        seen[value] = true;
+      }
+    }
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), true), senders);
+  }
+  EXPECT_GT(tested, 0U);
+}
+
+TEST(ShardedListenerTests, canPinThread)
+{
+  std::thread worker{[] {
+    EXPECT_NO_THROW(tss::pin_current_thread(0U));
+  }};
+  worker.join();
+}
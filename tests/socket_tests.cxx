@@ -3,8 +3,15 @@
 #include <tss/selector.hxx>
 #include <tss/socket.hxx>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <future>
+#include <span>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -163,3 +170,493 @@ TEST(SocketTests, canSendAndReceiveOverTcp6)
   server.join();
   client.join();
 }
+
+TEST(SocketTests, nonBlockingReceiveReportsWouldBlockWithoutThrowing)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12352U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  receiver.set_non_blocking();
+
+  int value{};
+  auto const nothing = receiver.receive_from(std::nothrow, nullptr, value);
+  ASSERT_FALSE(nothing);
+  EXPECT_TRUE(nothing.error().would_block());
+  EXPECT_THROW(receiver.receive_from(nullptr, value), tss::socket_error);
+
+  tss::udp_socket_4 sender{};
+  ASSERT_TRUE(sender.send_to(std::nothrow, address, 42));
+
+  tss::selector selector{};
+  selector.add_read(receiver);
+  selector.select(std::chrono::seconds{1});
+
+  tss::address_v4_t from{};
+  auto const received = receiver.receive_from(std::nothrow, &from, value);
+  ASSERT_TRUE(received);
+  EXPECT_EQ(*received, sizeof(int));
+  EXPECT_EQ(std::get<0U>(from), std::get<0U>(address));
+  EXPECT_EQ(value, 42);
+}
+
+TEST(SocketTests, nonBlockingAcceptAndConnectDoNotThrow)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 54324U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+  listener.set_non_blocking();
+
+  auto const none = listener.accept(std::nothrow, nullptr);
+  ASSERT_FALSE(none);
+  EXPECT_TRUE(none.error().would_block());
+
+  tss::tcp_socket_4 client{};
+  client.set_non_blocking();
+  if (auto const connected = client.connect(std::nothrow, address); !connected) {
+    EXPECT_TRUE(connected.error().in_progress()) << connected.error().message();
+  }
+
+  tss::selector selector{};
+  selector.add_read(listener);
+  selector.select(std::chrono::seconds{1});
+
+  auto accepted = listener.accept(std::nothrow, nullptr);
+  ASSERT_TRUE(accepted) << accepted.error().message();
+  EXPECT_TRUE(accepted->is_valid());
+}
+
+TEST(SocketTests, sendAllAndReceiveExactTransferLargePayloads)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12353U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  std::vector<int> values(1U<<20U);
+  for (std::size_t i = 0U; i<values.size(); ++i) {
+    values[i] = static_cast<int>(i);
+  }
+
+  std::thread client{[address, &values] {
+    tss::tcp_socket_4 sock{};
+    sock.connect(address);
+    sock.send_all(gsl::span<int const>{values});
+  }};
+
+  auto server = listener.accept(nullptr);
+  std::vector<int> received(values.size());
+  EXPECT_EQ(server.receive_exact(gsl::span<int>{received}), values.size()*sizeof(int));
+  EXPECT_EQ(received, values);
+
+  client.join();
+
+  int rest{};
+  EXPECT_EQ(server.receive_exact(rest), 0U);
+}
+
+TEST(SocketTests, canSendAndReceiveSpansOverUdp4)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12354U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  std::array<std::uint16_t, 5U> const values{1U, 2U, 3U, 4U, 5U};
+  EXPECT_EQ(sender.send_to(address, gsl::span{values}), sizeof(values));
+
+  std::array<std::uint16_t, 8U> received{};
+  EXPECT_EQ(receiver.receive_from(nullptr, gsl::span<std::uint16_t>{received}), sizeof(values));
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), received.begin()));
+}
+
+namespace {
+  template<typename TSocket, typename TData>
+  concept can_send = requires(TSocket& sock, TData const& data) {
+    sock.send(data);
+  };
+}
+
+TEST(SocketTests, canSendAndReceiveStandardSpans)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12402U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(1);
+  tss::tcp_socket_4 client{};
+  client.connect(address);
+  auto server = listener.accept(nullptr);
+
+  std::array<std::uint32_t, 8U> const values{1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U};
+  EXPECT_EQ(client.send(std::span<std::uint32_t const>{values}), sizeof(values));
+  client.send_all(std::span{values});
+
+  std::array<std::uint32_t, 8U> received{};
+  EXPECT_EQ(server.receive_exact(std::span<std::uint32_t>{received}), sizeof(received));
+  EXPECT_EQ(received, values);
+  received = {};
+  EXPECT_EQ(server.receive_exact(std::span{received}), sizeof(received));
+  EXPECT_EQ(received, values);
+
+  // views must not be sent as objects, which would transmit their pointer and size
+  static_assert(!can_send<tss::tcp_socket_4, std::string_view>);
+  static_assert(can_send<tss::tcp_socket_4, std::uint32_t>);
+}
+
+TEST(SocketTests, canSendAndReceiveVectored)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12355U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  tss::tcp_socket_4 client{};
+  client.connect(address);
+  auto server = listener.accept(nullptr);
+
+  std::uint32_t const header{3U};
+  std::array<std::uint16_t, 3U> const body{7U, 8U, 9U};
+  std::uint8_t const trailer{0xffU};
+  std::array<tss::const_buffer, 3U> const outgoing{
+      tss::make_buffer(header), tss::make_buffer(gsl::span{body}), tss::make_buffer(trailer)
+  };
+  auto const sent = client.send_vectored(outgoing);
+  EXPECT_EQ(sent.bytes, sizeof(header)+sizeof(body)+sizeof(trailer));
+  EXPECT_EQ(sent.buffers, 3U);
+  EXPECT_EQ(sent.offset, 0U);
+
+  std::uint32_t received_header{};
+  std::array<std::uint16_t, 3U> received_body{};
+  std::array<std::uint8_t, 4U> received_trailer{};
+  std::array<tss::mutable_buffer, 3U> incoming{
+      tss::make_buffer(received_header), tss::make_buffer(gsl::span{received_body}),
+      tss::make_buffer(received_trailer)
+  };
+
+  auto const received = server.receive_vectored(incoming);
+  EXPECT_EQ(received.bytes, sent.bytes);
+  EXPECT_EQ(received.buffers, 2U);
+  EXPECT_EQ(received.offset, 1U);
+  EXPECT_EQ(received_header, header);
+  EXPECT_EQ(received_body, body);
+  EXPECT_EQ(received_trailer[0U], trailer);
+
+  auto const remaining = tss::remaining_buffers(gsl::span{incoming}, received);
+  ASSERT_EQ(remaining.size(), 1U);
+  EXPECT_EQ(remaining[0U].data(), reinterpret_cast<std::byte*>(&received_trailer[1U]));
+  EXPECT_EQ(remaining[0U].size(), 3U);
+}
+
+TEST(SocketTests, canSendAndReceiveBatchesOverUdp4)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12356U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  std::array<std::uint32_t, 3U> const values{1U, 2U, 3U};
+  std::array<tss::outgoing_datagram<tss::ip_version_t::V4>, 3U> outgoing{};
+  for (std::size_t i = 0U; i<values.size(); ++i) {
+    outgoing[i] = {tss::make_buffer(values[i]), address};
+  }
+  EXPECT_EQ(sender.send_batch(outgoing), values.size());
+
+  std::array<std::uint32_t, 8U> received{};
+  std::array<tss::incoming_datagram<tss::ip_version_t::V4>, 8U> incoming{};
+  for (std::size_t i = 0U; i<received.size(); ++i) {
+    incoming[i].buffer = tss::make_buffer(received[i]);
+  }
+
+  std::size_t count{0U};
+  while (count<values.size()) {
+    count += receiver.receive_batch(gsl::span{incoming}.subspan(count));
+  }
+  ASSERT_EQ(count, values.size());
+  for (std::size_t i = 0U; i<count; ++i) {
+    EXPECT_EQ(incoming[i].length, sizeof(std::uint32_t));
+    EXPECT_EQ(std::get<0U>(incoming[i].address), std::get<0U>(address));
+    EXPECT_EQ(received[i], values[i]);
+  }
+}
+
+TEST(SocketTests, canSendSegmentedAndReceiveCoalescedOverUdp4)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12357U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+  try {
+    receiver.set_receive_offload();
+    sender.set_segment_size(0U);
+  }
+  catch (tss::socket_error const& ex) {
+    GTEST_SKIP() << "UDP segmentation offload is not available: " << ex.what();
+  }
+  EXPECT_TRUE(receiver.get_receive_offload());
+
+  std::size_t constexpr segment_size{1000U};
+  std::vector<std::uint8_t> payload(4U*segment_size-10U);
+  for (std::size_t i = 0U; i<payload.size(); ++i) {
+    payload[i] = static_cast<std::uint8_t>(i/segment_size);
+  }
+  EXPECT_EQ(sender.send_segmented(address, tss::make_buffer(gsl::span<std::uint8_t const>{payload}), segment_size),
+      payload.size());
+
+  std::vector<std::byte> buffer(1U<<16U);
+  std::size_t segment{0U};
+  for (std::size_t total = 0U; total<payload.size();) {
+    auto const datagram = receiver.receive_coalesced(nullptr, tss::mutable_buffer{buffer});
+    EXPECT_EQ(datagram.segment_size, std::min(segment_size, datagram.length));
+    for (auto const part: tss::segments(tss::mutable_buffer{buffer}.first(datagram.length), datagram.segment_size)) {
+      EXPECT_EQ(part.size(), std::min(segment_size, payload.size()-segment*segment_size));
+      EXPECT_EQ(std::to_integer<std::size_t>(part[0U]), segment);
+      ++segment;
+    }
+    total += datagram.length;
+  }
+  EXPECT_EQ(segment, 4U);
+
+  // an empty datagram is valid input and yields no segments
+  sender.send_to(address, gsl::span<std::uint8_t const>{});
+  auto const empty = receiver.receive_coalesced(nullptr, tss::mutable_buffer{buffer});
+  EXPECT_EQ(empty.length, 0U);
+  EXPECT_EQ(empty.segment_size, 1U);
+  auto const parts = tss::segments(tss::mutable_buffer{buffer}.first(empty.length), empty.segment_size);
+  EXPECT_EQ(parts.size(), 0U);
+  EXPECT_TRUE(parts.begin()==parts.end());
+}
+
+TEST(SocketTests, connectedUdpSocketsOnlyExchangeDatagramsWithTheirPeer)
+{
+  tss::address_v4_t const first_address{tss::resolve_ip_address_v4("127.0.0.1"), 12358U};
+  tss::address_v4_t const second_address{tss::resolve_ip_address_v4("127.0.0.1"), 12359U};
+
+  tss::udp_socket_4 first_sock{};
+  first_sock.bind(first_address);
+  tss::udp_socket_4 second_sock{};
+  second_sock.bind(second_address);
+
+  auto first = std::move(first_sock).connect(second_address);
+  auto second = std::move(second_sock).connect(first_address);
+  EXPECT_FALSE(first_sock.is_valid());
+  EXPECT_TRUE(first.is_valid());
+
+  tss::udp_socket_4 stranger{};
+  stranger.send_to(first_address, 99);
+
+  EXPECT_EQ(second.send(42), sizeof(int));
+  int value{};
+  EXPECT_EQ(first.receive(value), sizeof(int));
+  EXPECT_EQ(value, 42);
+
+  std::array<int, 2U> const values{1, 2};
+  EXPECT_EQ(first.send(gsl::span{values}), sizeof(values));
+  std::array<int, 2U> received{};
+  EXPECT_EQ(second.receive(gsl::span{received}), sizeof(values));
+  EXPECT_EQ(received, values);
+}
+
+TEST(SocketTests, canSendFiles)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12361U};
+
+  std::vector<std::uint32_t> values(1U<<20U);
+  for (std::size_t i = 0U; i<values.size(); ++i) {
+    values[i] = static_cast<std::uint32_t>(i);
+  }
+  auto const path = std::filesystem::temp_directory_path()/"tss_send_file_test.bin";
+  {
+    std::ofstream file{path, std::ios::binary};
+    file.write(reinterpret_cast<char const*>(values.data()),
+        static_cast<std::streamsize>(values.size()*sizeof(std::uint32_t)));
+  }
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  tss::tcp_socket_4 client{};
+  client.connect(address);
+  auto server = listener.accept(nullptr);
+
+  std::size_t sent{};
+  std::thread sender{[&client, &path, &sent] {
+    sent = client.send_file(path);
+    sent += client.send_file(path, 4U*sizeof(std::uint32_t), 2U*sizeof(std::uint32_t));
+  }};
+
+  std::vector<std::uint32_t> received(values.size()+2U);
+  EXPECT_EQ(server.receive_exact(gsl::span<std::uint32_t>{received}), received.size()*sizeof(std::uint32_t));
+  sender.join();
+  std::filesystem::remove(path);
+
+  EXPECT_EQ(sent, received.size()*sizeof(std::uint32_t));
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), received.begin()));
+  EXPECT_EQ(received[values.size()], 4U);
+  EXPECT_EQ(received[values.size()+1U], 5U);
+}
+
+TEST(SocketTests, acceptManyDrainsPendingConnections)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12372U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(16);
+  listener.set_non_blocking();
+
+  std::vector<tss::tcp_socket_4> accepted{};
+  EXPECT_EQ(listener.accept_many(16U, accepted), 0U);
+
+  std::vector<tss::tcp_socket_4> clients(10U);
+  for (auto& client: clients) {
+    client.connect(address);
+  }
+
+  tss::selector selector{};
+  selector.add_read(listener);
+  ASSERT_EQ(selector.select(std::chrono::seconds{1}), 1U);
+
+  std::vector<tss::address_v4_t> addresses{};
+  EXPECT_EQ(listener.accept_many(4U, accepted, &addresses), 4U);
+  while (accepted.size()<clients.size()) {
+    ASSERT_GT(listener.accept_many(16U, accepted, &addresses), 0U);
+  }
+  EXPECT_EQ(listener.accept_many(16U, accepted), 0U);
+  ASSERT_EQ(addresses.size(), clients.size());
+
+  for (std::size_t i = 0U; i<accepted.size(); ++i) {
+    EXPECT_EQ(std::get<0U>(addresses[i]), std::get<0U>(address));
+    std::uint32_t value{};
+    auto const received = accepted[i].receive(std::nothrow, value);
+    ASSERT_FALSE(received);
+    EXPECT_TRUE(received.error().would_block());
+  }
+
+  tss::address_v4_t peer{};
+  tss::tcp_socket_4 client{};
+  client.connect(address);
+  selector.clear();
+  selector.add_read(listener);
+  ASSERT_EQ(selector.select(std::chrono::seconds{1}), 1U);
+  auto const single = listener.accept(&peer);
+  EXPECT_EQ(std::get<0U>(peer), std::get<0U>(address));
+  EXPECT_NE(std::get<1U>(peer), 0U);
+}
+
+#if defined(__linux__)
+
+TEST(SocketTests, reportsKernelTimestampsOverUdp4)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12373U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.set_reuse_addr();
+  receiver.bind(address);
+  receiver.set_timestamping(tss::timestamping_t::RxSoftware);
+
+  // the kernel turns on receive timestamps asynchronously, so probe until they show up
+  tss::udp_socket_4 prober{};
+  bool enabled{false};
+  for (std::size_t attempt = 0U; attempt<100U && !enabled; ++attempt) {
+    prober.send_to(address, std::uint32_t{0xFFFFFFFFU});
+    std::uint32_t probe{};
+    enabled = receiver.receive_timestamped(nullptr, tss::make_buffer(probe)).time.software.has_value();
+  }
+  ASSERT_TRUE(enabled);
+
+  tss::udp_socket_4 sender{};
+  sender.set_timestamping(tss::timestamping_t::TxSoftware | tss::timestamping_t::TxScheduled);
+
+  auto const before = std::chrono::system_clock::now().time_since_epoch();
+  for (std::uint32_t i = 0U; i<2U; ++i) {
+    sender.send_to(address, i);
+  }
+
+  for (std::uint32_t i = 0U; i<2U; ++i) {
+    std::uint32_t value{};
+    tss::address_v4_t peer{};
+    auto const received = receiver.receive_timestamped(&peer, tss::make_buffer(value));
+    EXPECT_EQ(received.length, sizeof(value));
+    EXPECT_EQ(value, i);
+    EXPECT_EQ(std::get<0U>(peer), std::get<0U>(address));
+    ASSERT_TRUE(received.time.software);
+    EXPECT_GE(*received.time.software, before);
+    EXPECT_LE(*received.time.software, std::chrono::system_clock::now().time_since_epoch());
+    EXPECT_FALSE(received.time.hardware);
+  }
+
+  std::array<tss::tx_timestamp, 8U> reports{};
+  std::vector<tss::tx_timestamp> collected{};
+  tss::selector selector{};
+  while (collected.size()<4U) {
+    selector.clear();
+    selector.add_except(sender);
+    selector.add_read(sender);
+    ASSERT_GT(selector.select(std::chrono::seconds{1}), 0U);
+    auto const count = sender.receive_tx_timestamps(gsl::span<tss::tx_timestamp>{reports});
+    collected.insert(collected.end(), reports.begin(), reports.begin()+static_cast<std::ptrdiff_t>(count));
+  }
+
+  for (std::uint32_t id = 0U; id<2U; ++id) {
+    for (auto const stage: {tss::tx_stage_t::Scheduled, tss::tx_stage_t::Sent}) {
+      auto const report = std::find_if(collected.begin(), collected.end(), [id, stage](auto const& candidate) {
+        return candidate.id==id && candidate.stage==stage;
+      });
+      ASSERT_NE(report, collected.end());
+      ASSERT_TRUE(report->time.software);
+      EXPECT_GE(*report->time.software, before);
+    }
+  }
+  EXPECT_EQ(sender.receive_tx_timestamps(gsl::span<tss::tx_timestamp>{reports}), 0U);
+}
+
+TEST(SocketTests, reportsReceiveTimestampsOverTcp4)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12374U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(1);
+
+  tss::tcp_socket_4 client{};
+  client.connect(address);
+  auto server = listener.accept(nullptr);
+  server.set_timestamping(tss::timestamping_t::RxSoftware);
+
+  // the kernel turns on receive timestamps asynchronously, so probe until they show up
+  bool enabled{false};
+  for (std::size_t attempt = 0U; attempt<100U && !enabled; ++attempt) {
+    client.send(std::uint64_t{0U});
+    std::uint64_t probe{};
+    enabled = server.receive_timestamped(tss::make_buffer(probe)).time.software.has_value();
+  }
+  ASSERT_TRUE(enabled);
+
+  auto const before = std::chrono::system_clock::now().time_since_epoch();
+  client.send(std::uint64_t{42U});
+
+  std::uint64_t value{};
+  auto const received = server.receive_timestamped(tss::make_buffer(value));
+  EXPECT_EQ(received.length, sizeof(value));
+  EXPECT_EQ(value, 42U);
+  ASSERT_TRUE(received.time.software);
+  EXPECT_GE(*received.time.software, before);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <tss/socket.hxx>
+#include <tss/stats.hxx>
+
+#include <chrono>
+#include <cstdint>
+
+TEST(StatsTests, histogramEstimatesPercentilesByBucket)
+{
+  tss::latency_histogram histogram{};
+  EXPECT_EQ(histogram.percentile(0.5), std::chrono::nanoseconds{0});
+
+  histogram.buckets[10U] = 90U;
+  histogram.buckets[20U] = 10U;
+  EXPECT_EQ(histogram.count(), 100U);
+  EXPECT_EQ(histogram.percentile(0.0), std::chrono::nanoseconds{1 << 10});
+  EXPECT_EQ(histogram.percentile(0.9), std::chrono::nanoseconds{1 << 10});
+  EXPECT_EQ(histogram.percentile(0.91), std::chrono::nanoseconds{1 << 20});
+  EXPECT_EQ(histogram.percentile(1.0), std::chrono::nanoseconds{1 << 20});
+}
+
+TEST(StatsTests, countersClassifyResults)
+{
+  tss::detail::io_counters counters{};
+  counters.record(tss::io_operation_t::Send, std::chrono::nanoseconds{1500}, 100U, 100, false);
+  counters.record(tss::io_operation_t::Send, std::chrono::nanoseconds{1500}, 100U, 40, false);
+  counters.record(tss::io_operation_t::Send, std::chrono::nanoseconds{100}, 100U, -1, true);
+  counters.record(tss::io_operation_t::Receive, std::chrono::nanoseconds{0}, 100U, 10, false);
+  counters.record(tss::io_operation_t::Accept, std::chrono::nanoseconds{100}, 0U, -1, false);
+
+  auto const stats = counters.snapshot();
+  auto const& send = stats[tss::io_operation_t::Send];
+  EXPECT_EQ(send.calls, 3U);
+  EXPECT_EQ(send.bytes, 140U);
+  EXPECT_EQ(send.partial, 1U);
+  EXPECT_EQ(send.would_block, 1U);
+  EXPECT_EQ(send.errors, 0U);
+  EXPECT_EQ(send.latency.buckets[11U], 2U);
+  EXPECT_EQ(send.latency.buckets[7U], 1U);
+
+  auto const& receive = stats[tss::io_operation_t::Receive];
+  EXPECT_EQ(receive.calls, 1U);
+  EXPECT_EQ(receive.partial, 0U);
+  EXPECT_EQ(receive.latency.buckets[0U], 1U);
+
+  EXPECT_EQ(stats[tss::io_operation_t::Accept].errors, 1U);
+  EXPECT_EQ(stats[tss::io_operation_t::SendTo].calls, 0U);
+}
+
+TEST(StatsTests, socketsCountTheirCalls)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12375U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.set_reuse_addr();
+  receiver.bind(address);
+  receiver.set_non_blocking();
+
+  auto const before = tss::global_stats();
+  tss::udp_socket_4 sender{};
+  sender.send_to(address, std::uint64_t{1U});
+
+  std::uint64_t value{};
+  EXPECT_EQ(receiver.receive_from(nullptr, value), sizeof(value));
+  EXPECT_FALSE(receiver.receive_from(std::nothrow, nullptr, value));
+
+  auto const sent = sender.stats();
+  auto const received = receiver.stats();
+  auto const after = tss::global_stats();
+  if constexpr (tss::stats_enabled) {
+    EXPECT_EQ(sent[tss::io_operation_t::SendTo].calls, 1U);
+    EXPECT_EQ(sent[tss::io_operation_t::SendTo].bytes, sizeof(value));
+    EXPECT_EQ(sent[tss::io_operation_t::SendTo].latency.count(), 1U);
+    EXPECT_EQ(received[tss::io_operation_t::ReceiveFrom].calls, 2U);
+    EXPECT_EQ(received[tss::io_operation_t::ReceiveFrom].would_block, 1U);
+    EXPECT_GE(after[tss::io_operation_t::ReceiveFrom].calls, before[tss::io_operation_t::ReceiveFrom].calls+2U);
+
+    tss::udp_socket_4 moved{std::move(receiver)};
+    EXPECT_EQ(moved.stats()[tss::io_operation_t::ReceiveFrom].calls, 2U);
+  }
+  else {
+    EXPECT_EQ(sent[tss::io_operation_t::SendTo].calls, 0U);
+    EXPECT_EQ(received[tss::io_operation_t::ReceiveFrom].calls, 0U);
+    EXPECT_EQ(after[tss::io_operation_t::ReceiveFrom].calls, 0U);
+  }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <tss/socket.hxx>
+
+namespace tss::test {
+  /**
+   * Two TCP sockets connected to each other over the IPv4 loopback interface.
+   */
+  struct tcp_pair final {
+    tcp_socket_4 client{};
+    tcp_socket_4 server;
+
+    /**
+     * @param port The port to listen on while the connection is established.
+     */
+    explicit tcp_pair(port_t const port)
+        :server{connect_(port)}
+    {
+    }
+
+  private:
+    tcp_socket_4 connect_(port_t const port)
+    {
+      address_v4_t const address{resolve_ip_address_v4("127.0.0.1"), port};
+      tcp_socket_4 listener{};
+      listener.set_reuse_addr();
+      listener.bind(address);
+      listener.listen(1);
+      client.connect(address);
+      return listener.accept(nullptr);
+    }
+  };
+}
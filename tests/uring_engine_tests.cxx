@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <tss/exceptions.hxx>
+#include <tss/uring_engine.hxx>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <optional>
+
+namespace {
+  std::optional<tss::uring_engine> make_engine(std::uint32_t const registered_sockets = 0U)
+  {
+    try {
+      return std::optional<tss::uring_engine>{std::in_place, 64U, registered_sockets};
+    }
+    catch (tss::socket_error const& ex) {
+      if (ex.error_code()==ENOSYS || ex.error_code()==EPERM) {
+        return std::nullopt;
+      }
+      throw;
+    }
+  }
+
+  using completion_queue = std::deque<tss::uring_engine::completion>;
+
+  /**
+   * Wait for the completion of the given operation, keeping the completions of others in reaped.
+   */
+  tss::uring_engine::completion wait_for(
+      tss::uring_engine& engine,
+      completion_queue& reaped,
+      std::uint64_t const user_data
+  )
+  {
+    for (;;) {
+      auto const found = std::find_if(reaped.begin(), reaped.end(), [user_data](auto const& completion) {
+        return completion.user_data==user_data;
+      });
+      if (found!=reaped.end()) {
+        auto const completion = *found;
+        reaped.erase(found);
+        return completion;
+      }
+
+      auto const completions = engine.wait();
+      reaped.insert(reaped.end(), completions.begin(), completions.end());
+    }
+  }
+}
+
+TEST(UringEngineTests, canAcceptConnectSendAndReceiveOverTcp4)
+{
+  auto engine = make_engine();
+  if (!engine) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+
+  completion_queue reaped{};
+
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12407U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  tss::tcp_socket_4 client{};
+  engine->accept(listener, 1U);
+  engine->connect(client, address, 2U);
+
+  std::optional<tss::tcp_socket_4> server{};
+  for (int remaining = 2; remaining>0;) {
+    for (auto const& completion: engine->wait()) {
+      ASSERT_FALSE(completion.is_error()) << std::strerror(completion.error_code());
+      if (completion.user_data==1U) {
+        server.emplace(tss::uring_engine::accepted<tss::ip_version_t::V4>(completion));
+      }
+      --remaining;
+    }
+  }
+  ASSERT_TRUE(server.has_value());
+
+  int const value{42};
+  int received{};
+  engine->receive(*server, gsl::as_writable_bytes(gsl::span<int>{&received, 1U}), 3U);
+  engine->send(client, gsl::as_bytes(gsl::span<int const>{&value, 1U}), 4U);
+
+  EXPECT_EQ(wait_for(*engine, reaped, 3U).result, static_cast<std::int32_t>(sizeof(int)));
+  EXPECT_EQ(received, 42);
+}
+
+TEST(UringEngineTests, canSendAndReceiveOverUdp4WithRegisteredSockets)
+{
+  auto engine = make_engine(2U);
+  if (!engine) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+
+  completion_queue reaped{};
+
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12349U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  auto const registered_receiver = engine->register_socket(receiver);
+  auto const registered_sender = engine->register_socket(sender);
+
+  std::array<int, 4U> values{1, 2, 3, 4};
+  std::array<int, 4U> received{};
+  for (std::size_t i = 0U; i<values.size(); ++i) {
+    engine->receive(registered_receiver, gsl::as_writable_bytes(gsl::span<int>{&received[i], 1U}), i);
+  }
+  for (std::size_t i = 0U; i<values.size(); ++i) {
+    engine->send_to(registered_sender, address, gsl::as_bytes(gsl::span<int const>{&values[i], 1U}), 100U+i);
+  }
+
+  for (std::size_t i = 0U; i<values.size(); ++i) {
+    auto const completion = wait_for(*engine, reaped, i);
+    EXPECT_EQ(completion.result, static_cast<std::int32_t>(sizeof(int)));
+  }
+  std::sort(received.begin(), received.end());
+  EXPECT_EQ(received, values);
+
+  engine->unregister_socket(registered_receiver);
+  engine->unregister_socket(registered_sender);
+}
+
+TEST(UringEngineTests, multishotReceiveUsesProvidedBuffers)
+{
+  auto engine = make_engine();
+  if (!engine) {
+    GTEST_SKIP() << "io_uring is not available";
+  }
+
+  completion_queue reaped{};
+
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12350U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  std::array<int, 8U> storage{};
+  engine->provide_buffers(7U, gsl::as_writable_bytes(gsl::span{storage}), sizeof(int), 0U, 1U);
+  ASSERT_FALSE(wait_for(*engine, reaped, 1U).is_error());
+
+  engine->receive_multishot(receiver, 7U, 2U);
+  engine->submit();
+
+  for (int i = 0; i<3; ++i) {
+    sender.send_to(address, i);
+  }
+
+  for (int i = 0; i<3; ++i) {
+    auto const completion = wait_for(*engine, reaped, 2U);
+    ASSERT_FALSE(completion.is_error()) << std::strerror(completion.error_code());
+    EXPECT_TRUE(completion.has_more());
+    ASSERT_TRUE(completion.buffer_id().has_value());
+    EXPECT_EQ(storage[*completion.buffer_id()], i);
+  }
+}
+
+TEST(UringEngineTests, destructionCancelsPendingOperations)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12403U};
+
+  tss::udp_socket_4 receiver{};
+  receiver.bind(address);
+  tss::udp_socket_4 sender{};
+
+  int pending{-1};
+  {
+    auto engine = make_engine();
+    if (!engine) {
+      GTEST_SKIP() << "io_uring is not available";
+    }
+    engine->receive(receiver, gsl::as_writable_bytes(gsl::span<int>{&pending, 1U}), 1U);
+    engine->submit();
+  }
+
+  // the cancelled receive neither takes the datagram nor writes into its buffer
+  sender.send_to(address, 42);
+  int received{};
+  EXPECT_EQ(receiver.receive_from(nullptr, received), sizeof(int));
+  EXPECT_EQ(received, 42);
+  EXPECT_EQ(pending, -1);
+}
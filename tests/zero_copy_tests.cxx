@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <tss/exceptions.hxx>
+#include <tss/selector.hxx>
+#include <tss/zero_copy.hxx>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+TEST(ZeroCopyTests, completesSendsThroughTheErrorQueue)
+{
+  tss::address_v4_t const address{tss::resolve_ip_address_v4("127.0.0.1"), 12360U};
+
+  tss::tcp_socket_4 listener{};
+  listener.set_reuse_addr();
+  listener.bind(address);
+  listener.listen(5);
+
+  tss::tcp_socket_4 client{};
+  client.connect(address);
+  auto server = listener.accept(nullptr);
+
+  std::optional<tss::zero_copy_sender<tss::ip_version_t::V4>> sender{};
+  try {
+    sender.emplace(client);
+  }
+  catch (tss::socket_error const& ex) {
+    if (ex.error_code()==ENOPROTOOPT || ex.error_code()==EOPNOTSUPP) {
+      GTEST_SKIP() << "SO_ZEROCOPY is not available";
+    }
+    throw;
+  }
+
+  std::vector<std::byte> payload(1U<<20U, std::byte{0x5a});
+  std::thread reader{[&server, size = payload.size()] {
+    std::vector<std::byte> buffer(size);
+    server.receive_exact(gsl::span<std::byte>{buffer});
+  }};
+
+  auto const empty = sender->send(tss::const_buffer{});
+  EXPECT_EQ(empty.bytes, 0U);
+
+  std::vector<tss::zero_copy_handle> handles{};
+  for (auto rest = tss::const_buffer{payload}; !rest.empty();) {
+    auto const sent = sender->send(rest.first(std::min<std::size_t>(rest.size(), 1U<<16U)));
+    handles.push_back(sent.handle);
+    rest = rest.subspan(sent.bytes);
+  }
+  reader.join();
+
+  // the empty send is not mistaken for the send after it
+  EXPECT_NE(empty.handle, handles.front());
+  EXPECT_TRUE(sender->is_complete(empty.handle));
+
+  std::size_t completed{0U};
+  for (int attempt = 0; attempt<100 && sender->pending()>0U; ++attempt) {
+    tss::selector selector{};
+    selector.add_read(*sender);
+    selector.select(std::chrono::milliseconds{100});
+    completed += sender->reap();
+  }
+
+  EXPECT_EQ(sender->pending(), 0U);
+  EXPECT_EQ(completed, handles.size());
+  EXPECT_LE(sender->copied(), completed);
+  for (auto const handle: handles) {
+    EXPECT_TRUE(sender->is_complete(handle));
+  }
+}
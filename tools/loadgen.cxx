@@ -0,0 +1,669 @@
+/**
+ * Open-loop load generator for TCP and UDP echo servers.
+ *
+ * Requests are sent on a fixed schedule regardless of how fast responses arrive, and every latency is measured from
+ * the time a request was scheduled rather than actually sent. A stalling server therefore shows up in the percentiles
+ * instead of silently slowing down the load (coordinated omission). Unless a target is given, an echo server built on
+ * sharded_listener runs in the same process, so everything stays on loopback.
+ */
+#include <tss/poller.hxx>
+#include <tss/sharded_listener.hxx>
+#include <tss/socket.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+  using clock = std::chrono::steady_clock;
+
+  struct config final {
+    tss::protocol_t protocol{tss::protocol_t::TCP};
+    tss::ip_version_t ip{tss::ip_version_t::V4};
+    std::optional<std::string> target{};
+    tss::port_t port{12390U};
+    std::size_t connections{100U};
+    double rate{10000.0};
+    std::chrono::seconds duration{5};
+    std::size_t size{64U};
+    std::size_t churn{0U};
+    std::size_t threads{1U};
+    std::size_t server_threads{1U};
+  };
+
+  /**
+   * Log-linear histogram in the spirit of HdrHistogram: every power of two is split into 32 sub-buckets, which keeps
+   * the relative error of recorded values around 3 %.
+   */
+  class histogram final {
+  public:
+    static unsigned constexpr sub_bits = 5U;
+    static std::uint64_t constexpr sub_count = std::uint64_t{1U} << sub_bits;
+
+    void record(std::uint64_t const value)
+    {
+      ++counts_[index_of(value)];
+      ++count_;
+      max_ = std::max(max_, value);
+      sum_ += value;
+    }
+
+    void merge(histogram const& other)
+    {
+      for (std::size_t i = 0U; i<counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+      }
+      count_ += other.count_;
+      max_ = std::max(max_, other.max_);
+      sum_ += other.sum_;
+    }
+
+    [[nodiscard]] std::uint64_t count() const noexcept
+    {
+      return count_;
+    }
+
+    [[nodiscard]] std::uint64_t max() const noexcept
+    {
+      return max_;
+    }
+
+    [[nodiscard]] double mean() const noexcept
+    {
+      return count_==0U ? 0.0 : static_cast<double>(sum_)/static_cast<double>(count_);
+    }
+
+    [[nodiscard]] std::uint64_t percentile(double const fraction) const noexcept
+    {
+      auto const rank = std::max(std::uint64_t{1U}, static_cast<std::uint64_t>(fraction*static_cast<double>(count_)));
+      std::uint64_t seen{0U};
+      for (std::size_t i = 0U; i<counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen>=rank) {
+          return std::min(upper_bound_of(i), max_);
+        }
+      }
+      return max_;
+    }
+
+  private:
+    static std::size_t index_of(std::uint64_t const value) noexcept
+    {
+      if (value<sub_count) {
+        return static_cast<std::size_t>(value);
+      }
+      auto const exponent = static_cast<unsigned>(std::bit_width(value))-1U-sub_bits;
+      auto const mantissa = value >> exponent;
+      return static_cast<std::size_t>(((exponent+1U) << sub_bits)+(mantissa-sub_count));
+    }
+
+    static std::uint64_t upper_bound_of(std::size_t const index) noexcept
+    {
+      if (index<sub_count) {
+        return index;
+      }
+      auto const exponent = static_cast<unsigned>(index >> sub_bits)-1U;
+      auto const mantissa = (index & (sub_count-1U))+sub_count;
+      return ((mantissa+1U) << exponent)-1U;
+    }
+
+    std::vector<std::uint64_t> counts_ = std::vector<std::uint64_t>(64U << sub_bits);
+    std::uint64_t count_{0U};
+    std::uint64_t max_{0U};
+    std::uint64_t sum_{0U};
+  };
+
+  /**
+   * Every request starts with the time it was scheduled at, which the server echoes back.
+   */
+  struct message_header final {
+    std::uint64_t scheduled;
+    std::uint64_t sequence;
+  };
+
+  std::uint64_t now_ns() noexcept
+  {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count());
+  }
+
+  struct client_result final {
+    histogram latency{};
+    std::uint64_t sent{0U};
+    std::uint64_t received{0U};
+    std::uint64_t send_failures{0U};
+    std::uint64_t reconnects{0U};
+    std::uint64_t connect_failures{0U};
+  };
+
+  template<tss::ip_version_t TIP, tss::protocol_t TProto>
+  class client_worker final {
+    using stream_t = tss::socket<TIP, tss::protocol_t::TCP>;
+    using socket_t = std::conditional_t<TProto==tss::protocol_t::TCP, stream_t, tss::connected_udp_socket<TIP>>;
+
+    struct connection final {
+      std::optional<socket_t> sock{};
+      std::vector<std::byte> inbox{};
+      std::size_t filled{0U};
+      std::vector<std::byte> outbox{};
+      std::size_t outstanding{0U};
+      std::size_t completed{0U};
+      bool writing{false};
+    };
+
+  public:
+    client_worker(config const& settings, tss::address_t<TIP> const& address, std::size_t const connections)
+        :settings_{settings}, address_{address}, connections_(connections)
+    {
+      for (auto& current: connections_) {
+        current.inbox.resize(settings_.size);
+        open(current).value();
+      }
+    }
+
+    client_result run(double const rate, clock::time_point const start, clock::time_point const end)
+    {
+      auto const interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>{1.0/rate});
+      auto next_send = start;
+      std::uint64_t sequence{0U};
+      std::size_t next_connection{0U};
+      std::vector<std::byte> request(settings_.size);
+
+      auto const grace_end = end+std::chrono::seconds{1};
+      for (auto now = clock::now(); now<grace_end; now = clock::now()) {
+        // catch up on every request that is due, even if the server fell behind
+        while (now<end && next_send<=now) {
+          message_header const header{
+              static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  next_send.time_since_epoch()).count()),
+              sequence++
+          };
+          std::memcpy(request.data(), &header, sizeof(header));
+          send(connections_[next_connection], request);
+          next_connection = (next_connection+1U)%connections_.size();
+          next_send += interval;
+        }
+
+        if (now>=end && std::all_of(connections_.begin(), connections_.end(), [](auto const& current) {
+          return current.outstanding==0U;
+        })) {
+          break;
+        }
+
+        auto const wait = now<end ? std::chrono::duration_cast<std::chrono::milliseconds>(next_send-now)
+                                  : std::chrono::milliseconds{10};
+        for (auto const& event: poller_.wait(std::max(wait, std::chrono::milliseconds{0}))) {
+          auto& current = *static_cast<connection*>(event.user_data);
+          if (event.is_write()) {
+            flush(current);
+          }
+          if (event.is_read() || event.is_error() || event.is_hang_up()) {
+            receive(current);
+          }
+        }
+      }
+      return result_;
+    }
+
+  private:
+    /**
+     * Connect to the server. A connection that could not be established stays closed, so sends on it count as
+     * failures instead of ending the worker thread.
+     * @return The error code of the native connect call, if it failed.
+     */
+    tss::result<void> open(connection& current)
+    {
+      current.filled = 0U;
+      current.outbox.clear();
+      current.writing = false;
+      if constexpr (TProto==tss::protocol_t::TCP) {
+        stream_t sock{tss::options::tcp_nodelay{true}};
+        auto const connected = sock.connect(std::nothrow, address_);
+        if (!connected) {
+          return connected;
+        }
+        current.sock.emplace(std::move(sock));
+      }
+      else {
+        current.sock.emplace(tss::socket<TIP, tss::protocol_t::UDP>{}.connect(address_));
+      }
+      current.sock->set_non_blocking();
+      poller_.add(*current.sock, tss::poll_event_t::Read, &current);
+      return {};
+    }
+
+    void send(connection& current, std::vector<std::byte> const& request)
+    {
+      ++result_.sent;
+      if (!current.sock) {
+        ++result_.send_failures;
+        return;
+      }
+      ++current.outstanding;
+      if constexpr (TProto==tss::protocol_t::TCP) {
+        // queue behind data still waiting for the socket, the request keeps its scheduled time anyway
+        current.outbox.insert(current.outbox.end(), request.begin(), request.end());
+        flush(current);
+      }
+      else {
+        auto const sent = current.sock->send(std::nothrow, gsl::span<std::byte const>{request});
+        if (!sent) {
+          ++result_.send_failures;
+          --current.outstanding;
+        }
+      }
+    }
+
+    void flush(connection& current)
+    {
+      std::size_t offset{0U};
+      while (offset<current.outbox.size()) {
+        auto const sent = current.sock->send(std::nothrow,
+            gsl::span<std::byte const>{current.outbox}.subspan(offset));
+        if (!sent) {
+          if (!sent.error().would_block()) {
+            result_.send_failures += current.outstanding;
+            current.outstanding = 0U;
+            current.outbox.clear();
+            return;
+          }
+          break;
+        }
+        offset += *sent;
+      }
+      current.outbox.erase(current.outbox.begin(), current.outbox.begin()+static_cast<std::ptrdiff_t>(offset));
+
+      auto const writing = !current.outbox.empty();
+      if (writing!=current.writing) {
+        current.writing = writing;
+        poller_.modify(*current.sock, writing ? tss::poll_event_t::Read | tss::poll_event_t::Write
+                                              : tss::poll_event_t::Read, &current);
+      }
+    }
+
+    void receive(connection& current)
+    {
+      for (;;) {
+        auto const received = current.sock->receive(std::nothrow,
+            gsl::span<std::byte>{current.inbox}.subspan(current.filled));
+        if (!received || *received==0U) {
+          if (!received && received.error().would_block()) {
+            return;
+          }
+          // the server went away, whatever is outstanding on this connection is lost
+          poller_.remove(*current.sock);
+          current.sock.reset();
+          current.outstanding = 0U;
+          return;
+        }
+
+        current.filled += *received;
+        if (TProto==tss::protocol_t::UDP || current.filled==current.inbox.size()) {
+          complete(current);
+        }
+      }
+    }
+
+    void complete(connection& current)
+    {
+      message_header header{};
+      std::memcpy(&header, current.inbox.data(), sizeof(header));
+      result_.latency.record(now_ns()-header.scheduled);
+      ++result_.received;
+      current.filled = 0U;
+      --current.outstanding;
+      ++current.completed;
+
+      if constexpr (TProto==tss::protocol_t::TCP) {
+        if (settings_.churn>0U && current.completed%settings_.churn==0U && current.outstanding==0U) {
+          poller_.remove(*current.sock);
+          current.sock.reset();
+          if (open(current)) {
+            ++result_.reconnects;
+          }
+          else {
+            // e.g. a restarting server or exhausted ephemeral ports
+            ++result_.connect_failures;
+          }
+        }
+      }
+    }
+
+    config const& settings_;
+    tss::address_t<TIP> address_;
+    tss::poller poller_{4096U};
+    // connections register their own address with the poller, so they must never move
+    std::vector<connection> connections_;
+    client_result result_{};
+  };
+
+  /**
+   * Echoes every byte received, one thread per shard of a sharded_listener.
+   */
+  template<tss::ip_version_t TIP, tss::protocol_t TProto>
+  class echo_server final {
+  public:
+    echo_server(tss::address_t<TIP> const& address, std::size_t const threads)
+        :listener_{address, threads, tss::steering_t::Hash, 4096U}
+    {
+      for (auto& shard: listener_) {
+        shard.set_non_blocking();
+        workers_.emplace_back([this, &shard] {
+          serve(shard);
+        });
+      }
+    }
+
+    echo_server(echo_server const&) = delete;
+
+    echo_server& operator=(echo_server const&) = delete;
+
+    ~echo_server() noexcept
+    {
+      stop_ = true;
+      for (auto& worker: workers_) {
+        worker.join();
+      }
+    }
+
+  private:
+    using shard_t = tss::socket<TIP, TProto>;
+
+    struct stream final {
+      tss::socket<TIP, tss::protocol_t::TCP> sock;
+      std::vector<std::byte> pending{};
+      bool writing{false};
+    };
+
+    void serve(shard_t& shard)
+    {
+      tss::poller poller{4096U};
+      poller.add(shard, tss::poll_event_t::Read);
+      std::unordered_map<void*, std::unique_ptr<stream>> streams{};
+      std::vector<std::byte> buffer(64U*1024U);
+
+      while (!stop_) {
+        for (auto const& event: poller.wait(std::chrono::milliseconds{100})) {
+          if (event.is(shard)) {
+            accept(shard, poller, streams, buffer);
+            continue;
+          }
+
+          auto& current = *static_cast<stream*>(event.user_data);
+          if (!echo(current, buffer, poller)) {
+            poller.remove(current.sock);
+            streams.erase(&current);
+          }
+        }
+      }
+    }
+
+    template<typename TStreams>
+    void accept(shard_t& shard, tss::poller& poller, TStreams& streams, std::vector<std::byte>& buffer)
+    {
+      if constexpr (TProto==tss::protocol_t::TCP) {
+        (void) buffer;
+        std::vector<tss::socket<TIP, tss::protocol_t::TCP>> accepted{};
+        shard.accept_many(256U, accepted);
+        for (auto& sock: accepted) {
+          sock.template set<tss::options::tcp_nodelay>(true);
+          auto current = std::make_unique<stream>(stream{std::move(sock)});
+          poller.add(current->sock, tss::poll_event_t::Read, current.get());
+          streams.emplace(current.get(), std::move(current));
+        }
+      }
+      else {
+        (void) poller;
+        (void) streams;
+        tss::address_t<TIP> peer{};
+        for (;;) {
+          auto const received = shard.receive_from(std::nothrow, &peer, gsl::span<std::byte>{buffer});
+          if (!received) {
+            return;
+          }
+          (void) shard.send_to(std::nothrow, peer, gsl::span<std::byte const>{buffer}.first(*received));
+        }
+      }
+    }
+
+    /**
+     * @return false if the connection is done.
+     */
+    static bool echo(stream& current, std::vector<std::byte>& buffer, tss::poller& poller)
+    {
+      for (;;) {
+        auto const received = current.sock.receive(std::nothrow, gsl::span<std::byte>{buffer});
+        if (!received) {
+          if (!received.error().would_block()) {
+            return false;
+          }
+          break;
+        }
+        if (*received==0U) {
+          return false;
+        }
+        current.pending.insert(current.pending.end(), buffer.begin(),
+            buffer.begin()+static_cast<std::ptrdiff_t>(*received));
+      }
+
+      std::size_t offset{0U};
+      while (offset<current.pending.size()) {
+        auto const sent = current.sock.send(std::nothrow, gsl::span<std::byte const>{current.pending}.subspan(offset));
+        if (!sent) {
+          if (!sent.error().would_block()) {
+            return false;
+          }
+          break;
+        }
+        offset += *sent;
+      }
+      current.pending.erase(current.pending.begin(), current.pending.begin()+static_cast<std::ptrdiff_t>(offset));
+
+      auto const writing = !current.pending.empty();
+      if (writing!=current.writing) {
+        current.writing = writing;
+        poller.modify(current.sock, writing ? tss::poll_event_t::Read | tss::poll_event_t::Write
+                                            : tss::poll_event_t::Read, &current);
+      }
+      return true;
+    }
+
+    tss::sharded_listener<TIP, TProto> listener_;
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> workers_{};
+  };
+
+  template<tss::ip_version_t TIP>
+  tss::address_t<TIP> resolve(std::string_view const host, tss::port_t const port)
+  {
+    if constexpr (TIP==tss::ip_version_t::V4) {
+      return {tss::resolve_ip_address_v4(host), port};
+    }
+    else {
+      return {tss::resolve_ip_address_v6(host), port};
+    }
+  }
+
+  void print(config const& settings, client_result const& total, std::chrono::duration<double> const elapsed)
+  {
+    auto const microseconds = [](std::uint64_t const nanoseconds) {
+      return static_cast<double>(nanoseconds)/1000.0;
+    };
+
+    std::cout << "protocol:        " << (settings.protocol==tss::protocol_t::TCP ? "tcp" : "udp")
+        << (settings.ip==tss::ip_version_t::V4 ? "4" : "6") << '\n'
+        << "connections:     " << settings.connections << '\n'
+        << "target rate:     " << settings.rate << " req/s\n"
+        << "achieved rate:   " << static_cast<double>(total.received)/elapsed.count() << " req/s\n"
+        << "sent:            " << total.sent << '\n'
+        << "received:        " << total.received << '\n'
+        << "unanswered:      " << total.sent-std::min(total.sent, total.received+total.send_failures) << '\n'
+        << "send failures:   " << total.send_failures << '\n'
+        << "reconnects:      " << total.reconnects << '\n'
+        << "connect failures: " << total.connect_failures << '\n'
+        << "latency mean:    " << total.latency.mean()/1000.0 << " us\n";
+    for (auto const fraction: {0.5, 0.9, 0.99, 0.999, 0.9999}) {
+      std::cout << "latency p" << fraction*100.0 << ": " << microseconds(total.latency.percentile(fraction)) << " us\n";
+    }
+    std::cout << "latency max:     " << microseconds(total.latency.max()) << " us\n";
+  }
+
+  template<tss::ip_version_t TIP, tss::protocol_t TProto>
+  void run(config const& settings)
+  {
+    auto const address = resolve<TIP>(settings.target.value_or(TIP==tss::ip_version_t::V4 ? "127.0.0.1" : "::1"),
+        settings.port);
+    std::optional<echo_server<TIP, TProto>> server{};
+    if (!settings.target) {
+      server.emplace(address, settings.server_threads);
+    }
+
+    auto const threads = std::max(std::size_t{1U}, std::min(settings.threads, settings.connections));
+    std::vector<std::unique_ptr<client_worker<TIP, TProto>>> workers{};
+    for (std::size_t i = 0U; i<threads; ++i) {
+      auto const connections = settings.connections/threads+(i<settings.connections%threads ? 1U : 0U);
+      workers.push_back(std::make_unique<client_worker<TIP, TProto>>(settings, address, connections));
+    }
+
+    auto const start = clock::now()+std::chrono::milliseconds{100};
+    auto const end = start+settings.duration;
+    std::vector<client_result> results(threads);
+    std::vector<std::thread> running{};
+    for (std::size_t i = 0U; i<threads; ++i) {
+      running.emplace_back([&, i] {
+        results[i] = workers[i]->run(settings.rate/static_cast<double>(threads), start, end);
+      });
+    }
+    for (auto& thread: running) {
+      thread.join();
+    }
+
+    client_result total{};
+    for (auto const& result: results) {
+      total.latency.merge(result.latency);
+      total.sent += result.sent;
+      total.received += result.received;
+      total.send_failures += result.send_failures;
+      total.reconnects += result.reconnects;
+      total.connect_failures += result.connect_failures;
+    }
+    print(settings, total, end-start);
+  }
+
+  template<typename T>
+  T parse_number(std::string_view const name, std::string_view const text)
+  {
+    T value{};
+    auto const [end, error] = std::from_chars(text.data(), text.data()+text.size(), value);
+    if (error!=std::errc{} || end!=text.data()+text.size()) {
+      throw std::invalid_argument{"invalid value for " + std::string{name} + ": " + std::string{text}};
+    }
+    return value;
+  }
+
+  config parse(int const argc, char const* const* const argv)
+  {
+    config settings{};
+    for (int i = 1; i<argc; ++i) {
+      std::string_view const argument{argv[i]};
+      auto const separator = argument.find('=');
+      auto const name = argument.substr(0U, separator);
+      auto const value = separator==std::string_view::npos ? std::string_view{} : argument.substr(separator+1U);
+
+      if (name=="--protocol") {
+        settings.protocol = value=="udp" ? tss::protocol_t::UDP : tss::protocol_t::TCP;
+      }
+      else if (name=="--ip") {
+        settings.ip = value=="6" ? tss::ip_version_t::V6 : tss::ip_version_t::V4;
+      }
+      else if (name=="--target") {
+        settings.target = std::string{value};
+      }
+      else if (name=="--port") {
+        settings.port = parse_number<tss::port_t>(name, value);
+      }
+      else if (name=="--connections") {
+        settings.connections = std::max(std::size_t{1U}, parse_number<std::size_t>(name, value));
+      }
+      else if (name=="--rate") {
+        settings.rate = parse_number<double>(name, value);
+      }
+      else if (name=="--duration") {
+        settings.duration = std::chrono::seconds{parse_number<unsigned>(name, value)};
+      }
+      else if (name=="--size") {
+        settings.size = std::max(sizeof(message_header), parse_number<std::size_t>(name, value));
+      }
+      else if (name=="--churn") {
+        settings.churn = parse_number<std::size_t>(name, value);
+      }
+      else if (name=="--threads") {
+        settings.threads = parse_number<std::size_t>(name, value);
+      }
+      else if (name=="--server-threads") {
+        settings.server_threads = std::max(std::size_t{1U}, parse_number<std::size_t>(name, value));
+      }
+      else {
+        throw std::invalid_argument{"unknown option " + std::string{argument}};
+      }
+    }
+    if (settings.rate<=0.0) {
+      throw std::invalid_argument{"--rate must be positive"};
+    }
+    return settings;
+  }
+
+  /**
+   * Thousands of connections on both ends need more descriptors than the usual soft limit of 1024.
+   */
+  void raise_descriptor_limit() noexcept
+  {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit)==0 && limit.rlim_cur<limit.rlim_max) {
+      limit.rlim_cur = limit.rlim_max;
+      (void) ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+  }
+}
+
+int main(int const argc, char const* const* const argv)
+{
+  try {
+    auto const settings = ::parse(argc, argv);
+    ::raise_descriptor_limit();
+
+    if (settings.protocol==tss::protocol_t::TCP) {
+      settings.ip==tss::ip_version_t::V4 ? ::run<tss::ip_version_t::V4, tss::protocol_t::TCP>(settings)
+                                         : ::run<tss::ip_version_t::V6, tss::protocol_t::TCP>(settings);
+    }
+    else {
+      settings.ip==tss::ip_version_t::V4 ? ::run<tss::ip_version_t::V4, tss::protocol_t::UDP>(settings)
+                                         : ::run<tss::ip_version_t::V6, tss::protocol_t::UDP>(settings);
+    }
+    return 0;
+  }
+  catch (std::exception const& ex) {
+    std::cerr << "tss_loadgen: " << ex.what() << '\n'
+        << "usage: tss_loadgen [--protocol=tcp|udp] [--ip=4|6] [--target=<address>] [--port=<port>]\n"
+        << "                   [--connections=<n>] [--rate=<requests per second>] [--duration=<seconds>]\n"
+        << "                   [--size=<bytes>] [--churn=<requests per connection>] [--threads=<n>]\n"
+        << "                   [--server-threads=<n>]\n";
+    return 1;
+  }
+}